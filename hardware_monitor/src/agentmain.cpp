@@ -0,0 +1,44 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <csignal>
+#include <cstdio>
+#include "agentserver.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("hwmon-agent");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Envia CPU, RAM, PSI e núcleos para o HardwareMonitor remoto");
+    parser.addHelpOption();
+    QCommandLineOption stdioOption("stdio", "Fluxo na saída padrão (ex.: via ssh)");
+    QCommandLineOption listenOption("listen", "Aceita conexões TCP na porta", "porta");
+    QCommandLineOption bindOption("bind", "Endereço IPv4 de escuta (padrão 127.0.0.1)", "endereço", "127.0.0.1");
+    QCommandLineOption intervalOption("interval", "Intervalo entre amostras em ms", "ms", "1000");
+    parser.addOption(stdioOption);
+    parser.addOption(listenOption);
+    parser.addOption(bindOption);
+    parser.addOption(intervalOption);
+    parser.process(app);
+
+    if (parser.isSet(stdioOption) == parser.isSet(listenOption)) {
+        std::fprintf(stderr, "hwmon-agent: use --stdio ou --listen <porta>\n");
+        return 2;
+    }
+
+    // Cliente que some vira EPIPE tratado pelo servidor, não um sinal
+    std::signal(SIGPIPE, SIG_IGN);
+
+    AgentServer server(qMax(100, parser.value(intervalOption).toInt()));
+    if (parser.isSet(stdioOption)) {
+        server.serveStdio();
+    } else if (!server.listen(parser.value(bindOption).toLatin1(),
+                              quint16(parser.value(listenOption).toUInt()))) {
+        std::fprintf(stderr, "hwmon-agent: não foi possível escutar em %s:%s\n",
+                     qPrintable(parser.value(bindOption)), qPrintable(parser.value(listenOption)));
+        return 1;
+    }
+
+    return app.exec();
+}
@@ -0,0 +1,147 @@
+#include "agentserver.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+AgentServer::AgentServer(int intervalMs, QObject *parent)
+    : QObject(parent), listenFd(-1), listenNotifier(nullptr), stdioMode(false)
+{
+    char name[256] = {};
+    gethostname(name, sizeof(name) - 1);
+    hostName = name;
+
+    sampler.sample();
+    timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this, &AgentServer::tick);
+    timer->start(intervalMs);
+}
+
+AgentServer::~AgentServer()
+{
+    while (!clients.isEmpty()) {
+        dropClient(clients.last());
+    }
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+}
+
+bool AgentServer::listen(const QByteArray &address, quint16 port)
+{
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.constData(), &addr.sin_addr) != 1) {
+        return false;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) return false;
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    if (bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0
+        || ::listen(listenFd, 64) != 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    listenNotifier = new QSocketNotifier(listenFd, QSocketNotifier::Read, this);
+    connect(listenNotifier, &QSocketNotifier::activated, this, &AgentServer::acceptClients);
+    return true;
+}
+
+void AgentServer::serveStdio()
+{
+    stdioMode = true;
+    fcntl(STDOUT_FILENO, F_SETFL, fcntl(STDOUT_FILENO, F_GETFL) | O_NONBLOCK);
+    addClient(STDOUT_FILENO);
+}
+
+void AgentServer::acceptClients()
+{
+    for (;;) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;
+        // Quadros pequenos a cada segundo: sem esperar pelo Nagle
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        addClient(fd);
+    }
+}
+
+void AgentServer::addClient(int fd)
+{
+    Client *client = new Client(fd, hostName, sampler.fieldNames());
+    client->writeNotifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+    client->writeNotifier->setEnabled(false);
+    connect(client->writeNotifier, &QSocketNotifier::activated, this, &AgentServer::flushPending);
+    clients.append(client);
+}
+
+void AgentServer::dropClient(Client *client)
+{
+    clients.removeOne(client);
+    delete client->writeNotifier;
+    if (client->fd != STDOUT_FILENO) {
+        close(client->fd);
+    }
+    delete client;
+
+    if (stdioMode && clients.isEmpty()) {
+        QCoreApplication::quit();
+    }
+}
+
+void AgentServer::tick()
+{
+    sampler.sample();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Cópia: dropClient altera a lista
+    const QVector<Client *> current = clients;
+    for (Client *client : current) {
+        client->encoder.encode(now, sampler.values(), &client->backlog);
+        if (client->backlog.size() > MaxBacklogBytes || !writeBacklog(client)) {
+            dropClient(client);
+        }
+    }
+}
+
+void AgentServer::flushPending(int fd)
+{
+    for (Client *client : clients) {
+        if (client->fd != fd) continue;
+        if (!writeBacklog(client)) dropClient(client);
+        return;
+    }
+}
+
+bool AgentServer::writeBacklog(Client *client)
+{
+    int sent = 0;
+    while (sent < client->backlog.size()) {
+        ssize_t n = client->fd == STDOUT_FILENO
+                    ? ::write(client->fd, client->backlog.constData() + sent, client->backlog.size() - sent)
+                    : ::send(client->fd, client->backlog.constData() + sent, client->backlog.size() - sent,
+                             MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += int(n);
+    }
+    client->backlog.remove(0, sent);
+    // Só acorda pela escrita enquanto houver sobra
+    client->writeNotifier->setEnabled(!client->backlog.isEmpty());
+    return true;
+}
+
+#include "agentserver.moc"
@@ -0,0 +1,60 @@
+#ifndef AGENTSERVER_H
+#define AGENTSERVER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QSocketNotifier>
+#include <QVector>
+#include "hostsampler.h"
+#include "hoststream.h"
+
+// Laço do hwmon-agent: amostra a cada intervalo e envia o quadro delta a
+// cada cliente, seja a saída padrão (túnel SSH) ou conexões TCP aceitas.
+// Cada cliente tem seu próprio codificador, então quem conecta depois
+// recebe Hello e valores completos no primeiro quadro.
+class AgentServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AgentServer(int intervalMs, QObject *parent = nullptr);
+    ~AgentServer();
+
+    bool listen(const QByteArray &address, quint16 port);
+    // Fluxo na saída padrão; o agente termina quando ela fecha
+    void serveStdio();
+
+private slots:
+    void tick();
+    void acceptClients();
+    void flushPending(int fd);
+
+private:
+    struct Client
+    {
+        Client(int fd, const QByteArray &hostName, const QStringList &fields)
+            : fd(fd), encoder(hostName, fields), writeNotifier(nullptr) {}
+
+        int fd;
+        HostStreamEncoder encoder;
+        QByteArray backlog;          // bytes que o kernel ainda não aceitou
+        QSocketNotifier *writeNotifier;
+    };
+
+    void addClient(int fd);
+    bool writeBacklog(Client *client);
+    void dropClient(Client *client);
+
+    // Cliente que acumula mais que isso está parado: é desconectado
+    static constexpr int MaxBacklogBytes = 64 * 1024;
+
+    HostSampler sampler;
+    QTimer *timer;
+    QByteArray hostName;
+    int listenFd;
+    QSocketNotifier *listenNotifier;
+    QVector<Client *> clients;
+    bool stdioMode;
+};
+
+#endif
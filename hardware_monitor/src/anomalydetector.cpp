@@ -0,0 +1,60 @@
+#include "anomalydetector.h"
+#include <algorithm>
+#include <cmath>
+
+void AnomalyDetector::Ewma::update(double value, double alpha)
+{
+    if (samples == 0) {
+        mean = value;
+        variance = 0.0;
+    } else {
+        // Forma incremental de West para média e variância exponenciais
+        double diff = value - mean;
+        double increment = alpha * diff;
+        mean += increment;
+        variance = (1.0 - alpha) * (variance + diff * increment);
+    }
+    ++samples;
+}
+
+AnomalyDetector::AnomalyDetector(bool seasonal, double threshold)
+    : seasonal(seasonal), threshold(threshold), active(false)
+{
+}
+
+AnomalyDetector::Result AnomalyDetector::update(double value, int hourOfDay, int intervalMs)
+{
+    Result result = { 0.0, active, false };
+    if (std::isnan(value)) return result;
+
+    Ewma *hour = seasonal ? &hourly[qBound(0, hourOfDay, 23)] : nullptr;
+
+    // A linha de base sazonal só vale depois de ver uma hora inteira daquele
+    // horário; antes disso ela ainda não diz nada que o global não diga
+    const Ewma &baseline = (hour && hour->observedMs >= HourMs) ? *hour : global;
+
+    if (baseline.samples >= WarmupSamples) {
+        double stddev = std::max(std::sqrt(baseline.variance), MinStdDev);
+        result.zScore = (value - baseline.mean) / stddev;
+
+        // Histerese: entra acima do limiar, sai abaixo da metade dele
+        bool next = active ? std::fabs(result.zScore) > threshold / 2
+                           : std::fabs(result.zScore) > threshold;
+        result.changed = next != active;
+        active = next;
+        result.active = active;
+    }
+
+    global.update(value, Alpha);
+    if (hour) {
+        // Peso proporcional ao tempo: a amostra vale intervalMs de um
+        // horizonte de SeasonalDays horas. Até completar o horizonte é a
+        // média ponderada de tudo o que já foi visto, sem o viés da
+        // primeira amostra.
+        const double dt = qMax(intervalMs, 1);
+        hour->observedMs += dt;
+        const double alpha = qMax(dt / (HourMs * SeasonalDays), dt / hour->observedMs);
+        hour->update(value, alpha);
+    }
+    return result;
+}
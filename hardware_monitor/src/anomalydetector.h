@@ -0,0 +1,52 @@
+#ifndef ANOMALYDETECTOR_H
+#define ANOMALYDETECTOR_H
+
+#include <QtGlobal>
+#include <array>
+
+// Detector online de anomalias por z-score. Mantém média/variância por EWMA
+// e, opcionalmente, uma linha de base por hora do dia cuja memória é medida
+// em tempo, não em amostras: cobre a mesma hora de SeasonalDays dias
+// qualquer que seja a cadência. Cada amostra custa O(1), sem nenhuma
+// passada sobre o histórico.
+class AnomalyDetector
+{
+public:
+    struct Result
+    {
+        double zScore;
+        bool active;   // estado atual, com histerese
+        bool changed;  // entrou ou saiu de anomalia nesta amostra
+    };
+
+    explicit AnomalyDetector(bool seasonal = true, double threshold = 4.0);
+
+    // intervalMs: tempo desde a amostra anterior (a cadência muda com a
+    // visibilidade da janela e a bateria)
+    Result update(double value, int hourOfDay, int intervalMs);
+
+private:
+    struct Ewma
+    {
+        double mean = 0.0;
+        double variance = 0.0;
+        quint32 samples = 0;
+        double observedMs = 0.0;   // tempo coberto pelas amostras
+
+        void update(double value, double alpha);
+    };
+
+    static constexpr double Alpha = 0.02;          // ~50 amostras de memória
+    static constexpr int SeasonalDays = 7;         // memória de cada hora do dia
+    static constexpr double HourMs = 3600.0 * 1000.0;
+    static constexpr quint32 WarmupSamples = 60;
+    static constexpr double MinStdDev = 1.0;       // pontos percentuais
+
+    bool seasonal;
+    double threshold;
+    bool active;
+    Ewma global;
+    std::array<Ewma, 24> hourly;
+};
+
+#endif
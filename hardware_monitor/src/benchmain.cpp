@@ -0,0 +1,262 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <algorithm>
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "mainwindow.h"
+#include "procreader.h"
+
+namespace {
+
+// Arquivos do /proc lidos para o sistema todo; processos, cgroups e
+// sockets continuam vindo do /proc real
+const char *const replayedFiles[] = {
+    "stat", "meminfo", "pressure/cpu", "pressure/memory", "pressure/io", "diskstats",
+    "schedstat", "interrupts", "softirqs", "cpuinfo", "net/snmp", "net/netstat"
+};
+
+bool copyFile(const QString &from, const QString &to)
+{
+    QFile in(from);
+    if (!in.open(QIODevice::ReadOnly)) return false;
+    QByteArray data = in.readAll();
+
+    // Trunca sem trocar o inode: o ProcReader, com o descritor aberto,
+    // relê o conteúdo novo no próximo tick
+    QFile out(to);
+    return out.open(QIODevice::WriteOnly) && out.write(data) == data.size();
+}
+
+QString frameDirectory(const QString &directory, int frame)
+{
+    return QString("%1/%2").arg(directory).arg(frame, 5, 10, QChar('0'));
+}
+
+// Um quadro por subdiretório: DIR/00000/stat, DIR/00000/pressure/cpu...
+bool recordFrames(const QString &directory, int frames, int intervalMs)
+{
+    for (int frame = 0; frame < frames; ++frame) {
+        QString target = frameDirectory(directory, frame);
+        if (!QDir().mkpath(target + "/pressure") || !QDir().mkpath(target + "/net")) return false;
+        for (const char *file : replayedFiles) {
+            copyFile(QString("/proc/") + file, target + '/' + file);
+        }
+        if (frame + 1 < frames) QThread::msleep(intervalMs);
+    }
+    return true;
+}
+
+qint64 residentKb()
+{
+    ProcReader statm("/proc/self/statm");
+    if (!statm.read()) return 0;
+    quint64 pages = 0;
+    const char *p = skipToken(statm.begin(), statm.end());
+    parseUInt(skipSpaces(p, statm.end()), statm.end(), &pages);
+    return qint64(pages) * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+double cpuSeconds()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+           + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+QJsonObject distribution(QVector<qint64> samplesNs)
+{
+    QJsonObject out;
+    out["count"] = samplesNs.size();
+    if (samplesNs.isEmpty()) return out;
+
+    std::sort(samplesNs.begin(), samplesNs.end());
+    double sum = 0.0;
+    for (qint64 ns : samplesNs) sum += ns;
+    auto at = [&samplesNs](double q) {
+        return samplesNs[qMin(samplesNs.size() - 1, int(q * samplesNs.size()))] / 1e6;
+    };
+    out["mean_ms"] = sum / samplesNs.size() / 1e6;
+    out["p50_ms"] = at(0.50);
+    out["p95_ms"] = at(0.95);
+    out["max_ms"] = samplesNs.last() / 1e6;
+    return out;
+}
+
+// Cronometra a entrega dos eventos que interessam: UpdateRequest numa
+// janela de topo é um quadro inteiro (todos os widgets sujos pintados no
+// backing store), e o timer do SystemInfo é um tick inteiro, do /proc até
+// os slots da interface
+class BenchApplication : public QApplication
+{
+public:
+    BenchApplication(int &argc, char **argv) : QApplication(argc, argv), sampler(nullptr) {}
+
+    bool notify(QObject *receiver, QEvent *event) override
+    {
+        bool frame = event->type() == QEvent::UpdateRequest && receiver->isWidgetType();
+        bool tick = event->type() == QEvent::Timer && sampler && receiver->parent() == sampler;
+        if (!frame && !tick) return QApplication::notify(receiver, event);
+
+        QElapsedTimer clock;
+        clock.start();
+        bool result = QApplication::notify(receiver, event);
+        (frame ? frameNs : tickNs).append(clock.nsecsElapsed());
+        return result;
+    }
+
+    QObject *sampler;
+    QVector<qint64> frameNs;
+    QVector<qint64> tickNs;
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+    // Antes do QApplication: sem tela, e histórico, cache e memória
+    // compartilhada longe dos da sessão do usuário
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QTemporaryDir sandbox;
+    qputenv("XDG_DATA_HOME", QFile::encodeName(sandbox.path() + "/data"));
+    qputenv("XDG_CACHE_HOME", QFile::encodeName(sandbox.path() + "/cache"));
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(sandbox.path() + "/config"));
+    qputenv("HWMON_SHM_NAME", "/hwmon-bench-" + QByteArray::number(getpid()));
+
+    BenchApplication app(argc, argv);
+    QCoreApplication::setApplicationName("HardwareMonitor");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Roda a interface completa sem tela sobre um /proc gravado "
+                                     "e mede CPU, quadros e memória em JSON");
+    parser.addHelpOption();
+    QCommandLineOption recordOption("record", "Só grava quadros do /proc atual em <dir>", "dir");
+    QCommandLineOption replayOption("replay", "Quadros gravados com --record; sem isso grava "
+                                    "na hora, a cada 250 ms", "dir");
+    QCommandLineOption framesOption("frames", "Quadros a gravar (padrão 60)", "n", "60");
+    QCommandLineOption ticksOption("ticks", "Ticks medidos; cada um vale 1 s simulado (padrão 300)",
+                                   "n", "300");
+    QCommandLineOption warmupOption("warmup", "Ticks descartados antes de medir (padrão 20)",
+                                    "n", "20");
+    QCommandLineOption tickOption("tick-ms", "Intervalo real entre ticks (padrão 100, mínimo 100)",
+                                  "ms", "100");
+    QCommandLineOption outputOption("output", "Arquivo JSON; padrão: stdout", "arquivo");
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(framesOption);
+    parser.addOption(ticksOption);
+    parser.addOption(warmupOption);
+    parser.addOption(tickOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    const int frameCount = qMax(1, parser.value(framesOption).toInt());
+    if (parser.isSet(recordOption)) {
+        return recordFrames(parser.value(recordOption), frameCount, 1000) ? 0 : 1;
+    }
+
+    QString source = parser.value(replayOption);
+    if (source.isEmpty()) {
+        source = sandbox.path() + "/recorded";
+        recordFrames(source, frameCount, 250);
+    }
+    const QStringList frames = QDir(source).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    if (frames.isEmpty()) {
+        std::fprintf(stderr, "hwmon-bench: nenhum quadro em %s\n", qPrintable(source));
+        return 1;
+    }
+
+    // Raiz do /proc reproduzido; o quadro 0 já está lá quando o SystemInfo abre os arquivos
+    const QString root = sandbox.path() + "/proc";
+    QDir().mkpath(root + "/pressure");
+    QDir().mkpath(root + "/net");
+    int nextFrame = 0;
+    auto advance = [&]() {
+        const QString frame = source + '/' + frames[nextFrame];
+        for (const char *file : replayedFiles) {
+            copyFile(frame + '/' + file, root + '/' + file);
+        }
+        // Ao voltar ao quadro 0 os contadores regridem e um tick sai zerado
+        nextFrame = (nextFrame + 1) % frames.size();
+    };
+    advance();
+    qputenv("HWMON_PROC_ROOT", QFile::encodeName(root));
+
+    const int warmup = qMax(1, parser.value(warmupOption).toInt());
+    const int measured = qMax(1, parser.value(ticksOption).toInt());
+    const int tickMs = qMax(100, parser.value(tickOption).toInt());
+
+    MainWindow window;
+    window.show();
+
+    // Assinante extra só para acelerar o tick; a janela segue com o dela
+    SystemInfo *sampler = SystemInfo::instance();
+    app.sampler = sampler;
+    QObject pacer;
+    sampler->subscribe(&pacer, 0, tickMs);
+
+    int ticks = 0;
+    double cpuStart = 0.0;
+    qint64 rssStart = 0;
+    QElapsedTimer wall;
+    QObject::connect(sampler, &SystemInfo::statsUpdated, &pacer, [&](const Snapshot &) {
+        // Troca o quadro depois que o tick inteiro terminou de ler
+        QTimer::singleShot(0, &pacer, advance);
+
+        if (++ticks == warmup) {
+            cpuStart = cpuSeconds();
+            rssStart = residentKb();
+            app.frameNs.clear();
+            app.tickNs.clear();
+            wall.start();
+        } else if (ticks == warmup + measured) {
+            QCoreApplication::quit();
+        }
+    });
+    app.exec();
+
+    const double cpu = cpuSeconds() - cpuStart;
+    const qint64 rssEnd = residentKb();
+    const double simulatedHours = measured / 3600.0;
+
+    QJsonObject result;
+    result["platform"] = QString::fromLocal8Bit(qgetenv("QT_QPA_PLATFORM"));
+    result["replay_frames"] = frames.size();
+    result["ticks"] = measured;
+    result["tick_ms"] = tickMs;
+    result["wall_seconds"] = wall.elapsed() / 1000.0;
+    result["cpu_seconds"] = cpu;
+    result["cpu_seconds_per_simulated_hour"] = cpu / simulatedHours;
+    result["frames"] = app.frameNs.size();
+    result["frames_per_tick"] = double(app.frameNs.size()) / measured;
+    result["paint"] = distribution(app.frameNs);
+    result["tick"] = distribution(app.tickNs);
+    result["rss_start_kb"] = rssStart;
+    result["rss_end_kb"] = rssEnd;
+    result["rss_growth_kb_per_simulated_hour"] = (rssEnd - rssStart) / simulatedHours;
+
+    const QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile out(parser.value(outputOption));
+        if (!out.open(QIODevice::WriteOnly) || out.write(json) != json.size()) {
+            std::fprintf(stderr, "hwmon-bench: não foi possível gravar %s\n",
+                         qPrintable(parser.value(outputOption)));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+    return 0;
+}
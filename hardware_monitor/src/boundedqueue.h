@@ -0,0 +1,67 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+
+// Fila entre duas threads com capacidade fixa: o produtor espera quando
+// ela está cheia, então a memória em voo nunca passa de capacity itens.
+// close() encerra dos dois lados: push passa a falhar e pop devolve o que
+// restou e depois false.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(int capacity) : capacity(capacity), closed(false) {}
+
+    bool push(T item)
+    {
+        QMutexLocker locker(&mutex);
+        while (items.size() >= capacity && !closed) {
+            notFull.wait(&mutex);
+        }
+        if (closed) return false;
+        items.enqueue(std::move(item));
+        notEmpty.wakeOne();
+        return true;
+    }
+
+    bool pop(T *item)
+    {
+        QMutexLocker locker(&mutex);
+        while (items.isEmpty() && !closed) {
+            notEmpty.wait(&mutex);
+        }
+        if (items.isEmpty()) return false;
+        *item = items.dequeue();
+        notFull.wakeOne();
+        return true;
+    }
+
+    void close()
+    {
+        QMutexLocker locker(&mutex);
+        closed = true;
+        notFull.wakeAll();
+        notEmpty.wakeAll();
+    }
+
+    // Descarta o que estiver na fila (cancelamento)
+    void clear()
+    {
+        QMutexLocker locker(&mutex);
+        items.clear();
+        notFull.wakeAll();
+    }
+
+private:
+    QMutex mutex;
+    QWaitCondition notFull;
+    QWaitCondition notEmpty;
+    QQueue<T> items;
+    int capacity;
+    bool closed;
+};
+
+#endif
@@ -0,0 +1,257 @@
+#include "cgroupstats.h"
+#include "procreader.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char *findKey(const char *p, const char *end, const char *key)
+{
+    const int length = int(std::strlen(key));
+    while (p < end) {
+        if (end - p > length && std::memcmp(p, key, length) == 0) return p + length;
+        p = nextLine(p, end);
+    }
+    return nullptr;
+}
+
+}
+
+CgroupStats::CgroupStats(const QByteArray &root)
+    : bufferLength(0), reads(0), structureChanged(false), structureGeneration(0)
+{
+    // Só cgroup v2: a raiz tem cgroup.controllers
+    const QByteArray candidates[] = { root, "/sys/fs/cgroup", "/sys/fs/cgroup/unified" };
+    for (const QByteArray &candidate : candidates) {
+        if (candidate.isEmpty()) continue;
+        if (access((candidate + "/cgroup.controllers").constData(), F_OK) == 0) {
+            rootPath = candidate;
+            break;
+        }
+        if (!root.isEmpty()) break;
+    }
+    buffer.resize(16384);
+}
+
+bool CgroupStats::readFile(int dirFd, const char *name)
+{
+    ++reads;
+    bufferLength = 0;
+    int fd = openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    ssize_t n = ::read(fd, buffer.data(), buffer.size());
+    ::close(fd);
+    if (n <= 0) return false;
+    bufferLength = int(n);
+    return true;
+}
+
+QVector<QByteArray> CgroupStats::listChildren(int fd)
+{
+    QVector<QByteArray> names;
+    int copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    DIR *dir = copy >= 0 ? fdopendir(copy) : nullptr;
+    if (!dir) {
+        if (copy >= 0) ::close(copy);
+        return names;
+    }
+    while (dirent *entry = readdir(dir)) {
+        if (entry->d_type == DT_DIR && entry->d_name[0] != '.') {
+            names.append(QByteArray(entry->d_name));
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void CgroupStats::sample()
+{
+    if (!isAvailable()) return;
+
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+
+    previous.swap(current);
+    current.resize(0);
+    previousIndex.swap(currentIndex);
+    reads = 0;
+    structureChanged = false;
+
+    visit(AT_FDCWD, rootPath, QByteArray(), -1, 0, seconds);
+    static const QByteArray rootName("/");
+    if (!current.isEmpty()) current[0].name = rootName;
+
+    // Agregação de baixo para cima: na pré-ordem todo filho vem depois do
+    // pai, então basta percorrer de trás para frente somando no pai
+    for (int i = current.size() - 1; i > 0; --i) {
+        const CgroupNode &node = current[i];
+        CgroupNode &parent = current[node.parent];
+        parent.cpuPercent += node.cpuPercent;
+        parent.memoryBytes += node.memoryBytes;
+        parent.readBytesPerSec += node.readBytesPerSec;
+        parent.writeBytesPerSec += node.writeBytesPerSec;
+    }
+
+    if (structureChanged || current.size() != previous.size()) {
+        ++structureGeneration;
+        currentIndex.clear();
+        for (int i = 0; i < current.size(); ++i) {
+            currentIndex.insert(current[i].path, i);
+        }
+    } else {
+        currentIndex = previousIndex;
+    }
+}
+
+void CgroupStats::visit(int parentFd, const QByteArray &name, const QByteArray &path,
+                        int parent, int depth, double seconds)
+{
+    int fd = openat(parentFd, name.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        // Sumiu entre o readdir do pai e agora: força nova listagem no pai
+        if (parent >= 0) current[parent].mtimeNs = -1;
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return;
+    }
+    qint64 mtime = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+
+    // A raiz não tem cgroup.events
+    bool populated = true;
+    if (parent >= 0 && readFile(fd, "cgroup.events")) {
+        const char *value = findKey(buffer.constData(), buffer.constData() + bufferLength,
+                                    "populated ");
+        populated = !value || *value != '0';
+    }
+
+    int oldIndex = previousIndex.value(path, -1);
+    if (oldIndex >= 0 && !populated && !previous[oldIndex].populated
+            && previous[oldIndex].mtimeNs == mtime && previous[oldIndex].links == st.st_nlink) {
+        // Subárvore sem processos desde a última amostra: nada muda lá
+        // dentro, então é copiada inteira sem abrir nenhum arquivo
+        const int offset = current.size() - oldIndex;
+        const int size = previous[oldIndex].subtreeSize;
+        for (int i = oldIndex; i < oldIndex + size; ++i) {
+            CgroupNode node = previous[i];
+            node.parent = i == oldIndex ? parent : node.parent + offset;
+            node.cpuPercent = 0.0;
+            node.readBytesPerSec = 0.0;
+            node.writeBytesPerSec = 0.0;
+            if (node.subtreeSize > 1) node.memoryBytes = 0;
+            current.append(node);
+        }
+        ::close(fd);
+        return;
+    }
+
+    const int index = current.size();
+    current.append(oldIndex >= 0 ? previous[oldIndex] : CgroupNode());
+    CgroupNode &node = current[index];
+    node.name = name;
+    node.path = path;
+    node.parent = parent;
+    node.depth = depth;
+    node.populated = populated;
+
+    if (oldIndex < 0 || node.mtimeNs != mtime || node.links != st.st_nlink) {
+        QVector<QByteArray> children = listChildren(fd);
+        if (children != node.children) {
+            structureChanged = true;
+            node.childPaths.resize(0);
+            for (const QByteArray &child : children) {
+                node.childPaths.append(path.isEmpty() ? child : path + '/' + child);
+            }
+        }
+        node.children = children;
+        node.mtimeNs = mtime;
+        node.links = st.st_nlink;
+    }
+
+    if (node.children.isEmpty()) {
+        readLeaf(fd, node, seconds);
+    } else {
+        // Internos recebem a soma dos filhos depois da varredura
+        node.cpuPercent = 0.0;
+        node.memoryBytes = 0;
+        node.readBytesPerSec = 0.0;
+        node.writeBytesPerSec = 0.0;
+
+        // Cópias (compartilhadas): append() nos filhos pode realocar current
+        const QVector<QByteArray> children = node.children;
+        const QVector<QByteArray> childPaths = node.childPaths;
+        for (int i = 0; i < children.size(); ++i) {
+            visit(fd, children[i], childPaths[i], index, depth + 1, seconds);
+        }
+    }
+
+    current[index].subtreeSize = current.size() - index;
+    ::close(fd);
+}
+
+void CgroupStats::readLeaf(int fd, CgroupNode &node, double seconds)
+{
+    quint64 usage = node.cpuUsageUsec;
+    quint64 readBytes = node.readBytes;
+    quint64 writtenBytes = node.writtenBytes;
+
+    if (readFile(fd, "cpu.stat")) {
+        const char *end = buffer.constData() + bufferLength;
+        if (const char *value = findKey(buffer.constData(), end, "usage_usec ")) {
+            parseUInt(value, end, &usage);
+        }
+    }
+
+    // Sem o controlador de memória habilitado no pai o arquivo não existe
+    if (readFile(fd, "memory.current")) {
+        parseUInt(buffer.constData(), buffer.constData() + bufferLength, &node.memoryBytes);
+    }
+
+    // "8:0 rbytes=1234 wbytes=5678 rios=1 wios=2 dbytes=0 dios=0", um por dispositivo
+    if (readFile(fd, "io.stat")) {
+        readBytes = 0;
+        writtenBytes = 0;
+        const char *p = buffer.constData();
+        const char *end = p + bufferLength;
+        while (p < end) {
+            const char *lineEnd = nextLine(p, end);
+            p = skipSpaces(skipToken(p, lineEnd), lineEnd);
+            while (p < lineEnd && *p != '\n') {
+                const char *token = p;
+                p = skipToken(p, lineEnd);
+                quint64 value = 0;
+                if (p - token > 7 && std::memcmp(token, "rbytes=", 7) == 0) {
+                    parseUInt(token + 7, p, &value);
+                    readBytes += value;
+                } else if (p - token > 7 && std::memcmp(token, "wbytes=", 7) == 0) {
+                    parseUInt(token + 7, p, &value);
+                    writtenBytes += value;
+                }
+                p = skipSpaces(p, lineEnd);
+            }
+            p = lineEnd;
+        }
+    }
+
+    // Contadores que voltam (cgroup recriado com o mesmo nome) contam como zero
+    if (node.primed && seconds > 0.0) {
+        node.cpuPercent = usage >= node.cpuUsageUsec
+                              ? (usage - node.cpuUsageUsec) / (seconds * 1e4) : 0.0;
+        node.readBytesPerSec = readBytes >= node.readBytes
+                                   ? (readBytes - node.readBytes) / seconds : 0.0;
+        node.writeBytesPerSec = writtenBytes >= node.writtenBytes
+                                    ? (writtenBytes - node.writtenBytes) / seconds : 0.0;
+    }
+    node.cpuUsageUsec = usage;
+    node.readBytes = readBytes;
+    node.writtenBytes = writtenBytes;
+    node.primed = true;
+}
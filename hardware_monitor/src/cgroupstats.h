@@ -0,0 +1,79 @@
+#ifndef CGROUPSTATS_H
+#define CGROUPSTATS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+
+// Um diretório da árvore cgroup v2. Folhas têm valores próprios (lidos de
+// cpu.stat, memory.current e io.stat); nós internos são a soma dos filhos,
+// calculada de baixo para cima a cada amostra.
+struct CgroupNode
+{
+    QByteArray name;                // "sshd.service"; "/" na raiz
+    QByteArray path;                // relativo à raiz, vazio na própria raiz
+    int parent = -1;
+    int depth = 0;
+    int subtreeSize = 1;            // o nó e os descendentes, contíguos no vetor
+    bool populated = true;          // cgroup.events: há processos na subárvore
+
+    double cpuPercent = 0.0;        // 100 = um núcleo inteiro
+    quint64 memoryBytes = 0;
+    double readBytesPerSec = 0.0;
+    double writeBytesPerSec = 0.0;
+
+    // Estado da varredura: o readdir só é refeito quando mtime ou nlink do
+    // diretório mudam (nlink acompanha o nº de subdiretórios no cgroupfs,
+    // que nem sempre atualiza o mtime)
+    qint64 mtimeNs = -1;
+    quint64 links = 0;
+    QVector<QByteArray> children;
+    QVector<QByteArray> childPaths;   // path + '/' + nome, montados junto com children
+    quint64 cpuUsageUsec = 0;
+    quint64 readBytes = 0;
+    quint64 writtenBytes = 0;
+    bool primed = false;
+};
+
+class CgroupStats
+{
+public:
+    // Vazio: /sys/fs/cgroup, ou /sys/fs/cgroup/unified em hosts híbridos
+    explicit CgroupStats(const QByteArray &root = QByteArray());
+
+    bool isAvailable() const { return !rootPath.isEmpty(); }
+    const QByteArray &root() const { return rootPath; }
+
+    void sample();
+
+    // Pré-ordem a partir da raiz (índice 0): descendentes vêm logo após o pai
+    const QVector<CgroupNode> &nodes() const { return current; }
+    // Muda quando cgroups aparecem ou somem
+    quint32 generation() const { return structureGeneration; }
+    // Arquivos abertos na última amostra, para conferir o custo
+    int filesRead() const { return reads; }
+
+private:
+    void visit(int parentFd, const QByteArray &name, const QByteArray &path,
+               int parent, int depth, double seconds);
+    void readLeaf(int fd, CgroupNode &node, double seconds);
+    bool readFile(int dirFd, const char *name);
+    QVector<QByteArray> listChildren(int fd);
+
+    QByteArray rootPath;
+    QVector<CgroupNode> current;
+    QVector<CgroupNode> previous;
+    // path -> posição; só é remontado quando a estrutura muda, senão as
+    // posições do tick anterior continuam valendo
+    QHash<QByteArray, int> previousIndex;
+    QHash<QByteArray, int> currentIndex;
+    QByteArray buffer;
+    int bufferLength;
+    int reads;
+    bool structureChanged;
+    quint32 structureGeneration;
+    QElapsedTimer clock;
+};
+
+#endif
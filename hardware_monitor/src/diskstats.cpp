@@ -0,0 +1,80 @@
+#include "diskstats.h"
+#include <cstring>
+#include <unistd.h>
+
+DiskStats::DiskStats(const QByteArray &path)
+    : reader(path), listGeneration(0)
+{
+}
+
+bool DiskStats::isPhysical(const QByteArray &name)
+{
+    // Só discos inteiros com dispositivo por trás têm /sys/block/<nome>/device
+    auto it = physical.constFind(name);
+    if (it != physical.constEnd()) return it.value();
+
+    bool result = access(("/sys/block/" + name + "/device").constData(), F_OK) == 0;
+    physical.insert(name, result);
+    return result;
+}
+
+void DiskStats::sample()
+{
+    if (!reader.read()) return;
+
+    const char *p = reader.begin();
+    const char *end = reader.end();
+    int index = 0;
+    int line = 0;
+    bool changed = false;
+
+    while (p < end) {
+        const char *lineEnd = nextLine(p, end);
+
+        // "major minor nome leituras fundidas setores_lidos ms escritas fundidas setores_escritos ..."
+        const char *q = skipToken(skipSpaces(p, lineEnd), lineEnd);
+        q = skipToken(skipSpaces(q, lineEnd), lineEnd);
+        const char *nameStart = skipSpaces(q, lineEnd);
+        q = skipToken(nameStart, lineEnd);
+        const int nameLength = int(q - nameStart);
+
+        // A ordem das linhas não muda entre ticks: comparar com o nome visto
+        // na mesma linha evita montar um QByteArray por linha
+        if (line == lines.size()) lines.append(Line());
+        Line &cached = lines[line++];
+        if (cached.name.size() != nameLength
+                || std::memcmp(cached.name.constData(), nameStart, nameLength) != 0) {
+            cached.name = QByteArray(nameStart, nameLength);
+            cached.physical = nameLength > 0 && isPhysical(cached.name);
+        }
+        const QByteArray &name = cached.name;
+
+        if (cached.physical) {
+            quint64 fields[7] = {};
+            for (int i = 0; i < 7; ++i) {
+                q = parseUInt(skipSpaces(q, lineEnd), lineEnd, &fields[i]);
+            }
+
+            if (index == diskList.size()) {
+                diskList.append(DiskCounters());
+                changed = true;
+            }
+            DiskCounters &disk = diskList[index++];
+            if (disk.name != name) {
+                disk.name = name;
+                changed = true;
+            }
+            // Setores do diskstats são sempre de 512 bytes
+            disk.readBytes = fields[2] * 512;
+            disk.writtenBytes = fields[6] * 512;
+        }
+        p = lineEnd;
+    }
+
+    lines.resize(line);
+    if (index != diskList.size()) {
+        diskList.resize(index);
+        changed = true;
+    }
+    if (changed) ++listGeneration;
+}
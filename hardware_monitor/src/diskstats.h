@@ -0,0 +1,45 @@
+#ifndef DISKSTATS_H
+#define DISKSTATS_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include "procreader.h"
+
+struct DiskCounters
+{
+    QByteArray name;
+    quint64 readBytes = 0;      // acumulados desde o boot
+    quint64 writtenBytes = 0;
+};
+
+// Contadores de bytes lidos/escritos por disco físico, de /proc/diskstats.
+// Partições, loop, ram e dispositivos empilhados (dm, md) ficam de fora para
+// não contar o mesmo I/O duas vezes.
+class DiskStats
+{
+public:
+    explicit DiskStats(const QByteArray &path = "/proc/diskstats");
+
+    void sample();
+    const QVector<DiskCounters> &disks() const { return diskList; }
+    // Muda sempre que o conjunto de discos muda
+    quint32 generation() const { return listGeneration; }
+
+private:
+    struct Line
+    {
+        QByteArray name;
+        bool physical = false;
+    };
+
+    bool isPhysical(const QByteArray &name);
+
+    ProcReader reader;
+    QVector<Line> lines;
+    QVector<DiskCounters> diskList;
+    QHash<QByteArray, bool> physical;
+    quint32 listGeneration;
+};
+
+#endif
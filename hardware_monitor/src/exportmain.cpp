@@ -0,0 +1,82 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <cstdio>
+#include <limits>
+#include "metriclog.h"
+#include "historyexporter.h"
+
+namespace {
+
+// Aceita milissegundos desde a época ou data ISO ("2024-05-01T00:00")
+qint64 parseTime(const QString &text, qint64 fallback)
+{
+    if (text.isEmpty()) return fallback;
+    bool ok = false;
+    qint64 ms = text.toLongLong(&ok);
+    if (ok) return ms;
+    QDateTime dt = QDateTime::fromString(text, Qt::ISODate);
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : fallback;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("HardwareMonitor");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Exporta o histórico gravado para CSV ou .hwcol");
+    parser.addHelpOption();
+    QCommandLineOption dirOption("dir", "Diretório do histórico", "dir", MetricLog::defaultDirectory());
+    QCommandLineOption seriesOption("series", "Série a exportar; \"cpu_core\" inclui todas as "
+                                    "cpu_core{N}. Repetível; padrão: todas", "série");
+    QCommandLineOption fromOption("from", "Início (ms ou data ISO)", "início");
+    QCommandLineOption toOption("to", "Fim (ms ou data ISO)", "fim");
+    parser.addOption(dirOption);
+    parser.addOption(seriesOption);
+    parser.addOption(fromOption);
+    parser.addOption(toOption);
+    parser.addPositionalArgument("saida", "Arquivo .csv ou .hwcol");
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+
+    MetricLog log(parser.value(dirOption));
+    QStringList wanted = parser.values(seriesOption);
+    QStringList keys;
+    for (const QString &key : log.seriesKeys()) {
+        bool match = wanted.isEmpty();
+        for (const QString &w : wanted) {
+            match = match || key == w || key.startsWith(w + '{');
+        }
+        if (match) keys << key;
+    }
+    if (keys.isEmpty()) {
+        std::fprintf(stderr, "hwmon-export: nenhuma série encontrada em %s\n",
+                     qPrintable(parser.value(dirOption)));
+        return 1;
+    }
+
+    HistoryExporter exporter(parser.value(dirOption), keys,
+                             parseTime(parser.value(fromOption), 0),
+                             parseTime(parser.value(toOption), std::numeric_limits<qint64>::max() - 1),
+                             parser.positionalArguments().first());
+    int rc = 0;
+    // Sinais vêm da thread do exportador; com &app de contexto os lambdas
+    // rodam na fila da thread principal e o quit() não se perde antes do exec()
+    QObject::connect(&exporter, &HistoryExporter::progress, &app, [](qint64 rows, int percent) {
+        std::fprintf(stderr, "\r%lld linhas (%d%%)", static_cast<long long>(rows), percent);
+    });
+    QObject::connect(&exporter, &HistoryExporter::finished, &app, [&rc](bool ok, const QString &error) {
+        std::fprintf(stderr, ok ? "\n" : "\nhwmon-export: %s\n", qPrintable(error));
+        rc = ok ? 0 : 1;
+        QCoreApplication::quit();
+    });
+    exporter.start();
+    app.exec();
+    return rc;
+}
@@ -0,0 +1,172 @@
+#include "filesystemstats.h"
+#include <cstring>
+#include <poll.h>
+#include <sys/statvfs.h>
+
+namespace {
+
+// mountinfo escapa espaço, tab, \n e \ como \ooo em octal
+QByteArray unescapeField(const char *p, const char *end)
+{
+    QByteArray out;
+    out.reserve(end - p);
+    while (p < end) {
+        if (*p == '\\' && end - p >= 4) {
+            out.append(char((p[1] - '0') * 64 + (p[2] - '0') * 8 + (p[3] - '0')));
+            p += 4;
+        } else {
+            out.append(*p++);
+        }
+    }
+    return out;
+}
+
+bool isLocalDiskType(const char *type, int length)
+{
+    static const char *const types[] = {
+        "ext2", "ext3", "ext4", "xfs", "btrfs", "zfs", "f2fs", "vfat", "exfat", "ntfs", "ntfs3", "jfs", "reiserfs"
+    };
+    for (const char *t : types) {
+        if ((int)std::strlen(t) == length && std::memcmp(t, type, length) == 0) return true;
+    }
+    return false;
+}
+
+}
+
+double MountUsage::usedPercent() const
+{
+    // Mesmo critério do df: reservado para root não conta como livre
+    quint64 usable = usedBytes + availBytes;
+    return usable > 0 ? 100.0 * usedBytes / usable : 0.0;
+}
+
+double MountUsage::inodePercent() const
+{
+    return totalInodes > 0 ? 100.0 * (totalInodes - freeInodes) / totalInodes : 0.0;
+}
+
+FilesystemStats::FilesystemStats()
+    : mountinfo("/proc/self/mountinfo"), listGeneration(0)
+{
+}
+
+bool FilesystemStats::mountTableChanged()
+{
+    if (mountinfo.handle() < 0) return true;
+
+    // O kernel sinaliza POLLPRI|POLLERR quando a tabela muda desde o último poll
+    pollfd pfd = { mountinfo.handle(), POLLPRI, 0 };
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLPRI | POLLERR));
+}
+
+void FilesystemStats::parseMountTable()
+{
+    if (!mountinfo.read()) return;
+
+    QVector<MountUsage> parsed;
+    const char *p = mountinfo.begin();
+    const char *end = mountinfo.end();
+
+    while (p < end) {
+        const char *lineEnd = nextLine(p, end);
+
+        // "36 35 98:0 /root /mnt opts [opcionais...] - ext4 /dev/sda1 superopts"
+        const char *fields[5];
+        const char *fieldEnds[5];
+        const char *q = p;
+        for (int i = 0; i < 5; ++i) {
+            q = skipSpaces(q, lineEnd);
+            fields[i] = q;
+            q = skipToken(q, lineEnd);
+            fieldEnds[i] = q;
+        }
+
+        // " - " separa os campos opcionais; sep[-1] e sep[1] ficam dentro da
+        // linha mesmo na última, sem '\n' no fim do buffer
+        const char *sep = qMax(q, p + 1);
+        while (sep + 1 < lineEnd && !(sep[0] == '-' && sep[1] == ' ' && sep[-1] == ' ')) ++sep;
+        if (sep + 1 >= lineEnd) {
+            p = lineEnd;
+            continue;
+        }
+
+        const char *typeStart = skipSpaces(sep + 1, lineEnd);
+        const char *typeEnd = skipToken(typeStart, lineEnd);
+        const char *sourceStart = skipSpaces(typeEnd, lineEnd);
+        const char *sourceEnd = skipToken(sourceStart, lineEnd);
+
+        if (isLocalDiskType(typeStart, typeEnd - typeStart)) {
+            quint64 major = 0, minor = 0;
+            const char *mm = parseUInt(fields[2], fieldEnds[2], &major);
+            if (mm < fieldEnds[2] && *mm == ':') parseUInt(mm + 1, fieldEnds[2], &minor);
+            quint32 deviceId = quint32(major << 20 | minor);
+
+            bool duplicate = false;
+            for (const MountUsage &m : parsed) {
+                if (m.deviceId == deviceId) {
+                    duplicate = true;
+                    break;
+                }
+            }
+
+            if (!duplicate) {
+                MountUsage mount;
+                mount.mountPoint = unescapeField(fields[4], fieldEnds[4]);
+                mount.device = unescapeField(sourceStart, sourceEnd);
+                mount.fsType = QByteArray(typeStart, typeEnd - typeStart);
+                mount.deviceId = deviceId;
+
+                // Preserva os números já medidos até o próximo statvfs
+                for (const MountUsage &old : mountList) {
+                    if (old.deviceId == deviceId && old.mountPoint == mount.mountPoint) {
+                        mount = old;
+                        break;
+                    }
+                }
+                parsed.append(mount);
+            }
+        }
+        p = lineEnd;
+    }
+
+    bool same = parsed.size() == mountList.size();
+    for (int i = 0; same && i < parsed.size(); ++i) {
+        same = parsed[i].mountPoint == mountList[i].mountPoint;
+    }
+
+    mountList = parsed;
+    if (!same) {
+        ++listGeneration;
+    }
+}
+
+void FilesystemStats::refreshUsage()
+{
+    for (MountUsage &mount : mountList) {
+        struct statvfs st;
+        if (statvfs(mount.mountPoint.constData(), &st) != 0) continue;
+
+        mount.totalBytes = quint64(st.f_blocks) * st.f_frsize;
+        mount.availBytes = quint64(st.f_bavail) * st.f_frsize;
+        mount.usedBytes = quint64(st.f_blocks - st.f_bfree) * st.f_frsize;
+        mount.totalInodes = st.f_files;
+        mount.freeInodes = st.f_ffree;
+    }
+}
+
+bool FilesystemStats::sample()
+{
+    bool changed = mountTableChanged();
+    if (changed) {
+        parseMountTable();
+    }
+
+    if (!changed && statClock.isValid() && !statClock.hasExpired(StatIntervalMs)) {
+        return false;
+    }
+
+    statClock.start();
+    refreshUsage();
+    return true;
+}
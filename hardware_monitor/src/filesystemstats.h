@@ -0,0 +1,53 @@
+#ifndef FILESYSTEMSTATS_H
+#define FILESYSTEMSTATS_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QElapsedTimer>
+#include "procreader.h"
+
+struct MountUsage
+{
+    QByteArray mountPoint;
+    QByteArray device;
+    QByteArray fsType;
+    quint32 deviceId = 0;   // maj:min, para descartar bind mounts repetidos
+    quint64 totalBytes = 0;
+    quint64 availBytes = 0;
+    quint64 usedBytes = 0;
+    quint64 totalInodes = 0;
+    quint64 freeInodes = 0;
+
+    double usedPercent() const;
+    double inodePercent() const;
+};
+
+// Capacidade e inodes dos sistemas de arquivos locais. A tabela de montagem
+// vem de /proc/self/mountinfo e só é relida quando poll() no arquivo avisa
+// que ela mudou; statvfs roda no próprio ritmo, mais lento que o tick.
+class FilesystemStats
+{
+public:
+    FilesystemStats();
+
+    // true quando os números de uso foram atualizados nesta chamada
+    bool sample();
+
+    const QVector<MountUsage> &mounts() const { return mountList; }
+    // Muda sempre que a lista de montagens muda
+    quint32 generation() const { return listGeneration; }
+
+    static constexpr int StatIntervalMs = 10000;
+
+private:
+    bool mountTableChanged();
+    void parseMountTable();
+    void refreshUsage();
+
+    ProcReader mountinfo;
+    QVector<MountUsage> mountList;
+    quint32 listGeneration;
+    QElapsedTimer statClock;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "heatmapwidget.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontMetrics>
+#include <cmath>
+
+namespace {
+
+QColor levelColor(int level)
+{
+    if (level == 0) return QColor(235, 235, 235);
+    // Azul frio até vermelho em escala logarítmica de eventos/s
+    return QColor::fromHsv(220 - level * 14, 80 + level * 10, 250 - level * 6);
+}
+
+}
+
+HeatmapWidget::HeatmapWidget(QWidget *parent)
+    : QWidget(parent), cpus(0), labelWidth(0)
+{
+}
+
+int HeatmapWidget::levelFor(float rate)
+{
+    if (rate < 0.5f) return 0;
+    // ~3 níveis por década: 1/s -> 1, 100k/s -> 15
+    int level = 1 + (int)(std::log10(rate) * 2.8f);
+    return qBound(1, level, Levels - 1);
+}
+
+QRect HeatmapWidget::cellRect(int row, int cpu) const
+{
+    return QRect(labelWidth + cpu * CellSize, HeaderHeight + row * CellSize,
+                 CellSize - 1, CellSize - 1);
+}
+
+void HeatmapWidget::setMatrix(const IrqMatrix &matrix)
+{
+    QVector<int> rows;
+    rows.reserve(matrix.rows());
+    for (int r = 0; r < matrix.rows(); ++r) {
+        if (matrix.total(r) > 0) rows.append(r);
+    }
+
+    bool relayout = matrix.structureChanged() || rows != shownRows || matrix.cpus() != cpus;
+    if (relayout) {
+        shownRows = rows;
+        cpus = matrix.cpus();
+        labels.resize(rows.size());
+        levels.fill(0, rows.size() * cpus);
+
+        QFontMetrics metrics(font());
+        labelWidth = 0;
+        for (int i = 0; i < rows.size(); ++i) {
+            labels[i] = matrix.label(rows[i]);
+            labelWidth = qMax(labelWidth, metrics.horizontalAdvance(QString::fromLatin1(labels[i])));
+        }
+        labelWidth += 8;
+    }
+
+    for (int i = 0; i < shownRows.size(); ++i) {
+        quint8 *rowLevels = levels.data() + i * cpus;
+        for (int cpu = 0; cpu < cpus; ++cpu) {
+            quint8 level = (quint8)levelFor(matrix.rate(shownRows[i], cpu));
+            if (level != rowLevels[cpu]) {
+                rowLevels[cpu] = level;
+                if (!relayout) update(cellRect(i, cpu));
+            }
+        }
+    }
+
+    if (relayout) {
+        updateGeometry();
+        update();
+    }
+}
+
+QSize HeatmapWidget::sizeHint() const
+{
+    return QSize(labelWidth + cpus * CellSize + 4, HeaderHeight + shownRows.size() * CellSize + 4);
+}
+
+void HeatmapWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+
+    int firstRow = qMax(0, (dirty.top() - HeaderHeight) / CellSize);
+    int lastRow = qMin(shownRows.size() - 1, (dirty.bottom() - HeaderHeight) / CellSize);
+    int firstCpu = qMax(0, (dirty.left() - labelWidth) / CellSize);
+    int lastCpu = qMin(cpus - 1, (dirty.right() - labelWidth) / CellSize);
+
+    if (dirty.top() < HeaderHeight) {
+        // Rótulos a cada 4 CPUs, sempre nos múltiplos de 4: uma exposição
+        // parcial redesenha os mesmos textos por cima de fundo limpo
+        painter.fillRect(QRect(dirty.left(), 0, dirty.width(), HeaderHeight).intersected(dirty), palette().window());
+        for (int cpu = firstCpu - firstCpu % 4; cpu <= lastCpu; cpu += 4) {
+            painter.drawText(QRect(labelWidth + cpu * CellSize, 0, CellSize * 4, HeaderHeight),
+                             Qt::AlignLeft | Qt::AlignVCenter, QString::number(cpu));
+        }
+    }
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        if (dirty.left() < labelWidth) {
+            painter.drawText(QRect(0, HeaderHeight + row * CellSize, labelWidth - 4, CellSize),
+                             Qt::AlignRight | Qt::AlignVCenter, QString::fromLatin1(labels[row]));
+        }
+        const quint8 *rowLevels = levels.constData() + row * cpus;
+        for (int cpu = firstCpu; cpu <= lastCpu; ++cpu) {
+            painter.fillRect(cellRect(row, cpu), levelColor(rowLevels[cpu]));
+        }
+    }
+}
+
+#include "heatmapwidget.moc"
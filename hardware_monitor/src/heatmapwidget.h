@@ -0,0 +1,40 @@
+#ifndef HEATMAPWIDGET_H
+#define HEATMAPWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QByteArray>
+#include "interruptstats.h"
+
+// Mapa de calor IRQ x CPU. Cada célula guarda o nível de cor já desenhado e
+// só as que mudaram de nível são invalidadas, então um tick estável não
+// repinta nada.
+class HeatmapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HeatmapWidget(QWidget *parent = nullptr);
+
+    void setMatrix(const IrqMatrix &matrix);
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static int levelFor(float rate);
+    QRect cellRect(int row, int cpu) const;
+
+    static constexpr int CellSize = 14;
+    static constexpr int HeaderHeight = 16;
+    static constexpr int Levels = 16;
+
+    QVector<int> shownRows;      // linhas da matriz com algum evento
+    QVector<QByteArray> labels;
+    QVector<quint8> levels;      // shownRows.size() x cpus
+    int cpus;
+    int labelWidth;
+};
+
+#endif
@@ -0,0 +1,287 @@
+#include "historyexporter.h"
+#include "metriclog.h"
+#include "varint.h"
+#include <QFile>
+#include <QPair>
+#include <QtEndian>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+const char Magic[8] = { 'H', 'W', 'C', 'O', 'L', '1', '\n', '\0' };
+
+void appendChunk(QByteArray &out, const QByteArray &raw)
+{
+    QByteArray compressed = qCompress(raw, 6);
+    putVarint(out, quint64(compressed.size()));
+    out.append(compressed);
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray &out, T value)
+{
+    T le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&le), sizeof(le));
+}
+
+// Leitura de uma série em pedaços de ChunkRecords registros
+struct Cursor
+{
+    int series = -1;
+    qint64 next = 0;
+    qint64 end = 0;
+    QVector<qint64> timestamps;
+    QVector<float> values;
+    int pos = 0;
+    int size = 0;
+};
+
+QByteArray csvField(const QString &text)
+{
+    QByteArray bytes = text.toUtf8();
+    if (!bytes.contains(',') && !bytes.contains('"')) return bytes;
+    return '"' + bytes.replace("\"", "\"\"") + '"';
+}
+
+}
+
+HistoryExporter::HistoryExporter(const QString &logDirectory, const QStringList &seriesKeys,
+                                 qint64 fromMs, qint64 toMs, const QString &outputPath,
+                                 QObject *parent)
+    : QObject(parent), directory(logDirectory), keys(seriesKeys), fromMs(fromMs), toMs(toMs),
+      outputPath(outputPath), format(formatFor(outputPath)), queue(QueueCapacity),
+      reader(nullptr), writer(nullptr), cancelled(false), recordsRead(0), recordsTotal(0)
+{
+}
+
+HistoryExporter::~HistoryExporter()
+{
+    cancel();
+    for (QThread *thread : { reader, writer }) {
+        if (thread) {
+            thread->wait();
+            delete thread;
+        }
+    }
+}
+
+HistoryExporter::Format HistoryExporter::formatFor(const QString &path)
+{
+    return path.endsWith(".hwcol", Qt::CaseInsensitive) ? Columnar : Csv;
+}
+
+void HistoryExporter::start()
+{
+    reader = QThread::create([this]() { readBatches(); });
+    writer = QThread::create([this]() { writeBatches(); });
+    // A amostragem continua na thread principal sem disputar CPU
+    reader->start(QThread::LowPriority);
+    writer->start(QThread::LowPriority);
+}
+
+void HistoryExporter::cancel()
+{
+    cancelled = true;
+    queue.close();
+    queue.clear();
+}
+
+void HistoryExporter::setError(const QString &message)
+{
+    QMutexLocker locker(&errorMutex);
+    if (error.isEmpty()) error = message;
+}
+
+void HistoryExporter::readBatches()
+{
+    // Instância própria: o MetricLog da interface não é usado entre threads
+    MetricLog log(directory);
+    const QStringList available = log.seriesKeys();
+
+    QVector<Cursor> cursors(keys.size());
+    qint64 total = 0;
+    for (int i = 0; i < keys.size(); ++i) {
+        Cursor &c = cursors[i];
+        c.series = available.indexOf(keys[i]);
+        if (c.series >= 0 && log.rawRange(c.series, fromMs, toMs, &c.next, &c.end)) {
+            total += c.end - c.next;
+        }
+        c.timestamps.resize(ChunkRecords);
+        c.values.resize(ChunkRecords);
+    }
+    recordsTotal = total;
+
+    // Só um pedaço de cada série fica em memória; repõe quando esgota
+    auto refill = [&log](Cursor &c) {
+        if (c.pos < c.size) return true;
+        if (c.next >= c.end) return false;
+        int n = log.readRaw(c.series, c.next, int(qMin<qint64>(ChunkRecords, c.end - c.next)),
+                            c.timestamps.data(), c.values.data());
+        if (n <= 0) {
+            c.next = c.end;
+            return false;
+        }
+        c.next += n;
+        c.pos = 0;
+        c.size = n;
+        return true;
+    };
+
+    const int rowsPerBatch = qMax(1024, TargetBatchBytes / (8 + 4 * qMax(1, keys.size())));
+    const float missing = std::numeric_limits<float>::quiet_NaN();
+    qint64 read = 0;
+    bool more = true;
+
+    while (more && !cancelled) {
+        Batch batch;
+        batch.timestamps.reserve(rowsPerBatch);
+        batch.columns.resize(keys.size());
+        for (QVector<float> &column : batch.columns) {
+            column.reserve(rowsPerBatch);
+        }
+
+        // Merge pelas séries: cada linha é o menor timestamp entre as cabeças
+        while (batch.timestamps.size() < rowsPerBatch) {
+            qint64 t = std::numeric_limits<qint64>::max();
+            for (Cursor &c : cursors) {
+                if (refill(c)) t = qMin(t, c.timestamps[c.pos]);
+            }
+            if (t == std::numeric_limits<qint64>::max()) {
+                more = false;
+                break;
+            }
+
+            batch.timestamps.append(t);
+            for (int i = 0; i < cursors.size(); ++i) {
+                Cursor &c = cursors[i];
+                if (c.pos < c.size && c.timestamps[c.pos] == t) {
+                    batch.columns[i].append(c.values[c.pos++]);
+                    ++read;
+                } else {
+                    batch.columns[i].append(missing);
+                }
+            }
+        }
+
+        recordsRead = read;
+        if (batch.timestamps.isEmpty() || !queue.push(batch)) break;
+    }
+    queue.close();
+}
+
+void HistoryExporter::writeBatches()
+{
+    QFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        cancel();
+        emit finished(false, file.errorString());
+        return;
+    }
+
+    QByteArray out;
+    QByteArray raw;
+    QVector<QPair<qint64, quint32>> groups;
+
+    if (format == Csv) {
+        out = "timestamp_ms";
+        for (const QString &key : keys) {
+            out += ',' + csvField(key);
+        }
+        out += '\n';
+    } else {
+        out.append(Magic, sizeof(Magic));
+        putVarint(out, quint64(keys.size()));
+        for (const QString &key : keys) {
+            QByteArray name = key.toUtf8();
+            putVarint(out, quint64(name.size()));
+            out.append(name);
+        }
+    }
+
+    qint64 rows = 0;
+    Batch batch;
+    while (!cancelled && queue.pop(&batch)) {
+        const int n = batch.timestamps.size();
+
+        if (format == Csv) {
+            char number[32];
+            for (int r = 0; r < n; ++r) {
+                out.append(number, std::snprintf(number, sizeof(number), "%lld",
+                                                 static_cast<long long>(batch.timestamps[r])));
+                for (const QVector<float> &column : batch.columns) {
+                    out.append(',');
+                    if (!std::isnan(column[r])) {
+                        out.append(number, std::snprintf(number, sizeof(number), "%.7g", column[r]));
+                    }
+                }
+                out.append('\n');
+            }
+        } else {
+            groups.append(qMakePair(file.pos() + out.size(), quint32(n)));
+            putVarint(out, quint64(n));
+
+            // Delta-de-delta reiniciado por grupo: cada grupo decodifica sozinho
+            raw.clear();
+            qint64 previous = 0;
+            qint64 previousDelta = 0;
+            for (qint64 t : batch.timestamps) {
+                qint64 delta = t - previous;
+                putVarint(raw, zigzag(delta - previousDelta));
+                previousDelta = delta;
+                previous = t;
+            }
+            appendChunk(out, raw);
+
+            raw.resize(4 * n);
+            for (const QVector<float> &column : batch.columns) {
+                const uchar *src = reinterpret_cast<const uchar *>(column.constData());
+                char *dst = raw.data();
+                for (int i = 0; i < n; ++i) {
+                    for (int b = 0; b < 4; ++b) {
+                        dst[b * n + i] = char(src[4 * i + b]);
+                    }
+                }
+                appendChunk(out, raw);
+            }
+        }
+
+        if (file.write(out) != out.size()) {
+            setError(file.errorString());
+            cancel();
+            break;
+        }
+        out.clear();
+        rows += n;
+
+        qint64 total = recordsTotal;
+        emit progress(rows, total > 0 ? int(100 * recordsRead / total) : 100);
+    }
+
+    if (!cancelled && format == Columnar) {
+        for (const QPair<qint64, quint32> &group : groups) {
+            appendLittleEndian(out, group.first);
+            appendLittleEndian(out, group.second);
+        }
+        appendLittleEndian(out, quint32(groups.size()));
+        out.append(Magic, sizeof(Magic));
+        if (file.write(out) != out.size()) {
+            setError(file.errorString());
+            cancelled = true;
+        }
+    }
+
+    file.close();
+    if (cancelled) {
+        file.remove();
+        setError("exportação cancelada");
+    }
+
+    errorMutex.lock();
+    QString message = error;
+    errorMutex.unlock();
+    emit finished(!cancelled, cancelled ? message : QString());
+}
+
+#include "historyexporter.moc"
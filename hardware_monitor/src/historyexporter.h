@@ -0,0 +1,86 @@
+#ifndef HISTORYEXPORTER_H
+#define HISTORYEXPORTER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+#include "boundedqueue.h"
+
+// Exporta um intervalo do MetricLog como tabela (uma linha por instante,
+// uma coluna por série) em CSV ou no formato colunar .hwcol. Duas threads
+// de baixa prioridade: a leitora faz o merge das séries em lotes de
+// linhas e a escritora codifica e grava; entre elas uma BoundedQueue
+// limita a memória a alguns lotes, qualquer que seja o intervalo.
+//
+// Formato .hwcol (inteiros fixos em little-endian):
+//
+//   "HWCOL1\n\0", varint nº de colunas, nomes (varint tamanho + UTF-8)
+//   grupos de linhas: varint linhas, bloco de timestamps e um bloco por
+//     coluna; cada bloco é varint tamanho + qCompress() (zlib com 4 bytes
+//     de tamanho original na frente) de:
+//       timestamps  delta-de-delta em zigzag varint (amostragem regular
+//                   vira uma sequência de zeros)
+//       valores     float32 com os bytes separados em planos (todos os
+//                   bytes 0, depois todos os 1...); NaN = sem amostra
+//   rodapé: por grupo qint64 offset + quint32 linhas, quint32 nº de
+//     grupos e de novo "HWCOL1\n\0"
+class HistoryExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format { Csv, Columnar };
+
+    HistoryExporter(const QString &logDirectory, const QStringList &seriesKeys,
+                    qint64 fromMs, qint64 toMs, const QString &outputPath,
+                    QObject *parent = nullptr);
+    ~HistoryExporter();
+
+    // .hwcol -> Columnar, qualquer outra extensão -> Csv
+    static Format formatFor(const QString &path);
+
+    void start();
+    void cancel();
+
+signals:
+    void progress(qint64 rows, int percent);
+    void finished(bool ok, const QString &error);
+
+private:
+    struct Batch
+    {
+        QVector<qint64> timestamps;
+        QVector<QVector<float>> columns;   // NaN onde a série não tem amostra
+    };
+
+    void readBatches();
+    void writeBatches();
+    void setError(const QString &message);
+
+    // Alvo de memória por lote; com 3 lotes na fila e 2 em uso o total
+    // fica em poucos MiB mesmo com centenas de colunas
+    static constexpr int TargetBatchBytes = 2 * 1024 * 1024;
+    static constexpr int QueueCapacity = 3;
+    static constexpr int ChunkRecords = 4096;
+
+    QString directory;
+    QStringList keys;
+    qint64 fromMs;
+    qint64 toMs;
+    QString outputPath;
+    Format format;
+
+    BoundedQueue<Batch> queue;
+    QThread *reader;
+    QThread *writer;
+    std::atomic<bool> cancelled;
+    std::atomic<qint64> recordsRead;
+    std::atomic<qint64> recordsTotal;
+    QMutex errorMutex;
+    QString error;
+};
+
+#endif
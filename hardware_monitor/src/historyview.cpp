@@ -0,0 +1,199 @@
+#include "historyview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QDateTime>
+#include <QPolygonF>
+#include <cmath>
+
+namespace {
+
+QColor seriesColor(int index)
+{
+    return QColor::fromHsv((index * 67) % 360, 200, 190);
+}
+
+}
+
+HistoryView::HistoryView(QWidget *parent)
+    : QWidget(parent), log(nullptr), fromMs(0), toMs(0), minValue(0.0f), maxValue(0.0f),
+      dragX(0), dragFromMs(0), dragToMs(0)
+{
+    setMinimumHeight(160);
+}
+
+QSize HistoryView::sizeHint() const
+{
+    return QSize(480, 240);
+}
+
+void HistoryView::setLog(const MetricLog *newLog)
+{
+    log = newLog;
+    series.clear();
+    buckets.clear();
+    update();
+}
+
+void HistoryView::setSeries(const QVector<int> &ids)
+{
+    series = ids;
+    refresh();
+}
+
+QRect HistoryView::plotRect() const
+{
+    // Margens para os rótulos de valor (esquerda) e de tempo (embaixo)
+    return rect().adjusted(48, 8, -8, -22);
+}
+
+double HistoryView::xFor(qint64 timestampMs) const
+{
+    QRect plot = plotRect();
+    if (toMs <= fromMs) return plot.left();
+    return plot.left() + double(timestampMs - fromMs) * plot.width() / double(toMs - fromMs);
+}
+
+qint64 HistoryView::timeAt(int x) const
+{
+    QRect plot = plotRect();
+    if (plot.width() <= 0) return fromMs;
+    return fromMs + qint64(double(x - plot.left()) * (toMs - fromMs) / plot.width());
+}
+
+void HistoryView::resetRange()
+{
+    bool any = false;
+    for (int id : series) {
+        qint64 first = 0;
+        qint64 last = 0;
+        if (!log || !log->timeRange(id, &first, &last)) continue;
+        fromMs = any ? qMin(fromMs, first) : first;
+        toMs = any ? qMax(toMs, last) : last;
+        any = true;
+    }
+    if (any && toMs - fromMs < MinSpanMs) {
+        toMs = fromMs + MinSpanMs;
+    }
+    refresh();
+}
+
+void HistoryView::refresh()
+{
+    buckets.clear();
+    minValue = 0.0f;
+    maxValue = 0.0f;
+
+    int pixels = qMax(1, plotRect().width());
+    bool first = true;
+    for (int id : series) {
+        QVector<LodBucket> data = log ? log->query(id, fromMs, toMs, pixels) : QVector<LodBucket>();
+        for (const LodBucket &bucket : data) {
+            minValue = first ? bucket.min : qMin(minValue, bucket.min);
+            maxValue = first ? bucket.max : qMax(maxValue, bucket.max);
+            first = false;
+        }
+        buckets.append(data);
+    }
+    update();
+}
+
+void HistoryView::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+
+    QRect plot = plotRect();
+    painter.setPen(palette().mid().color());
+    painter.drawRect(plot);
+
+    bool empty = true;
+    for (const QVector<LodBucket> &data : buckets) {
+        if (!data.isEmpty()) empty = false;
+    }
+    if (empty) {
+        painter.drawText(plot, Qt::AlignCenter, "Sem dados no intervalo");
+        return;
+    }
+
+    float low = minValue;
+    float high = maxValue > minValue ? maxValue : minValue + 1.0f;
+    auto yFor = [&](float value) {
+        return plot.bottom() - double(value - low) * plot.height() / double(high - low);
+    };
+
+    painter.setPen(palette().text().color());
+    painter.drawText(QRect(0, plot.top(), plot.left() - 4, 16), Qt::AlignRight, QString::number(high, 'f', 1));
+    painter.drawText(QRect(0, plot.bottom() - 16, plot.left() - 4, 16), Qt::AlignRight, QString::number(low, 'f', 1));
+    const QString format("dd/MM HH:mm:ss");
+    painter.drawText(QRect(plot.left(), plot.bottom() + 4, plot.width(), 16), Qt::AlignLeft,
+                     QDateTime::fromMSecsSinceEpoch(fromMs).toString(format));
+    painter.drawText(QRect(plot.left(), plot.bottom() + 4, plot.width(), 16), Qt::AlignRight,
+                     QDateTime::fromMSecsSinceEpoch(toMs).toString(format));
+
+    painter.setClipRect(plot);
+    for (int s = 0; s < buckets.size(); ++s) {
+        const QVector<LodBucket> &data = buckets[s];
+        QColor color = seriesColor(s);
+        QColor band = color;
+        band.setAlpha(70);
+
+        QPolygonF means;
+        means.reserve(data.size());
+        for (const LodBucket &bucket : data) {
+            double x0 = xFor(bucket.firstMs);
+            double x1 = qMax(xFor(bucket.lastMs), x0 + 1.0);
+            double top = yFor(bucket.max);
+            painter.fillRect(QRectF(x0, top, x1 - x0, qMax(1.0, yFor(bucket.min) - top)), band);
+            means.append(QPointF((x0 + x1) / 2.0, yFor(bucket.mean)));
+        }
+        painter.setPen(color);
+        painter.drawPolyline(means);
+    }
+}
+
+void HistoryView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    refresh();
+}
+
+void HistoryView::wheelEvent(QWheelEvent *event)
+{
+    int steps = event->angleDelta().y() / 120;
+    if (steps == 0 || toMs <= fromMs) return;
+
+    // Zoom em torno do instante sob o cursor
+    qint64 anchor = timeAt(event->pos().x());
+    double ratio = double(anchor - fromMs) / double(toMs - fromMs);
+    qint64 span = qMax(MinSpanMs, qint64((toMs - fromMs) * std::pow(0.8, steps)));
+    fromMs = anchor - qint64(span * ratio);
+    toMs = fromMs + span;
+    refresh();
+    event->accept();
+}
+
+void HistoryView::mousePressEvent(QMouseEvent *event)
+{
+    dragX = event->pos().x();
+    dragFromMs = fromMs;
+    dragToMs = toMs;
+}
+
+void HistoryView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::LeftButton) || plotRect().width() <= 0) return;
+
+    qint64 shift = qint64(double(dragX - event->pos().x()) * (dragToMs - dragFromMs) / plotRect().width());
+    fromMs = dragFromMs + shift;
+    toMs = dragToMs + shift;
+    refresh();
+}
+
+void HistoryView::mouseDoubleClickEvent(QMouseEvent *)
+{
+    resetRange();
+}
+
+#include "historyview.moc"
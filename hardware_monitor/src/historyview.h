@@ -0,0 +1,58 @@
+#ifndef HISTORYVIEW_H
+#define HISTORYVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include "metriclog.h"
+
+// Gráfico de um MetricLog com zoom (roda do mouse) e arraste. A cada
+// mudança de intervalo só se pedem ao log tantos buckets quanto pixels de
+// largura: faixa min/max por bucket e linha pela média.
+class HistoryView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryView(QWidget *parent = nullptr);
+
+    void setLog(const MetricLog *log);
+    void setSeries(const QVector<int> &series);
+    // Enquadra tudo que o log tem das séries escolhidas
+    void resetRange();
+    // Relê os buckets do intervalo atual
+    void refresh();
+    // Intervalo enquadrado agora
+    qint64 rangeFrom() const { return fromMs; }
+    qint64 rangeTo() const { return toMs; }
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRect plotRect() const;
+    double xFor(qint64 timestampMs) const;
+    qint64 timeAt(int x) const;
+
+    static constexpr qint64 MinSpanMs = 10000;
+
+    const MetricLog *log;
+    QVector<int> series;
+    QVector<QVector<LodBucket>> buckets;   // um vetor por série
+    qint64 fromMs;
+    qint64 toMs;
+    float minValue;
+    float maxValue;
+
+    int dragX;
+    qint64 dragFromMs;
+    qint64 dragToMs;
+};
+
+#endif
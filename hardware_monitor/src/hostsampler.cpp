@@ -0,0 +1,145 @@
+#include "hostsampler.h"
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+// "0.12" -> 0.12; só o formato fixo do /proc/pressure
+const char *parseFixed(const char *p, const char *end, double *value)
+{
+    quint64 whole = 0;
+    quint64 fraction = 0;
+    double scale = 1.0;
+    p = parseUInt(p, end, &whole);
+    if (p < end && *p == '.') {
+        const char *start = ++p;
+        p = parseUInt(p, end, &fraction);
+        for (const char *d = start; d < p; ++d) scale *= 10.0;
+    }
+    *value = whole + fraction / scale;
+    return p;
+}
+
+bool startsWith(const char *p, const char *end, const char *prefix)
+{
+    size_t n = std::strlen(prefix);
+    return size_t(end - p) >= n && std::memcmp(p, prefix, n) == 0;
+}
+
+}
+
+HostSampler::HostSampler()
+    : stat("/proc/stat"), meminfo("/proc/meminfo"), psiCpu("/proc/pressure/cpu"),
+      psiMemory("/proc/pressure/memory"), psiIo("/proc/pressure/io")
+{
+    fields << "cpu" << "mem" << "psi_cpu_some" << "psi_mem_some" << "psi_mem_full"
+           << "psi_io_some" << "psi_io_full";
+
+    // Um campo por CPU configurada, online ou não: a lista de campos vai
+    // uma vez só para o cliente e não pode mudar quando um núcleo volta
+    const int cores = qMax(1, int(sysconf(_SC_NPROCESSORS_CONF)));
+    for (int i = 0; i < cores; ++i) {
+        fields << QString("cpu_core{%1}").arg(i);
+    }
+
+    previousIdle.fill(0, cores + 1);
+    previousTotal.fill(0, cores + 1);
+    current.fill(0.0, fields.size());
+}
+
+void HostSampler::sample()
+{
+    readCpu();
+    readMemory();
+    readPressure(psiCpu, PsiCpuSome, -1);
+    readPressure(psiMemory, PsiMemSome, PsiMemFull);
+    readPressure(psiIo, PsiIoSome, PsiIoFull);
+}
+
+void HostSampler::readCpu()
+{
+    if (!stat.read()) return;
+
+    const char *p = stat.begin();
+    const char *end = stat.end();
+    if (!startsWith(p, end, "cpu ")) return;
+    updateCpu(p, end, 0, Cpu);
+
+    // CPUs offline não aparecem, então o índice é o N de "cpuN", não a
+    // posição da linha
+    int expected = 0;
+    for (p = nextLine(p, end); startsWith(p, end, "cpu"); p = nextLine(p, end)) {
+        quint64 number = 0;
+        const char *digits = p + 3;
+        if (parseUInt(digits, end, &number) == digits) break;
+        if (number >= quint64(previousTotal.size() - 1)) continue;
+        const int core = int(number);
+
+        // Núcleos pulados desde a última linha ficaram offline: sem base
+        for (; expected < core; ++expected) {
+            previousTotal[expected + 1] = 0;
+            current[FirstCore + expected] = 0.0;
+        }
+        expected = core + 1;
+        updateCpu(p, end, core + 1, FirstCore + core);
+    }
+    for (; expected < previousTotal.size() - 1; ++expected) {
+        previousTotal[expected + 1] = 0;
+        current[FirstCore + expected] = 0.0;
+    }
+}
+
+void HostSampler::updateCpu(const char *p, const char *end, int slot, int field)
+{
+    // user nice system idle iowait irq softirq, como no SystemInfo
+    quint64 v[7] = {};
+    const char *q = skipToken(p, end);
+    for (int i = 0; i < 7; ++i) {
+        q = parseUInt(skipSpaces(q, end), end, &v[i]);
+    }
+    quint64 idle = v[3] + v[4];
+    quint64 total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6];
+
+    // 0: primeira leitura ou núcleo que voltou agora; o delta sai no próximo tick
+    if (previousTotal[slot] != 0 && total > previousTotal[slot]) {
+        quint64 totalDiff = total - previousTotal[slot];
+        quint64 idleDiff = idle - previousIdle[slot];
+        current[field] = 100.0 * (totalDiff - idleDiff) / totalDiff;
+    }
+    previousIdle[slot] = idle;
+    previousTotal[slot] = total;
+}
+
+void HostSampler::readMemory()
+{
+    if (!meminfo.read()) return;
+
+    quint64 totalKb = 0;
+    quint64 availableKb = 0;
+    const char *end = meminfo.end();
+    for (const char *p = meminfo.begin(); p < end; p = nextLine(p, end)) {
+        if (startsWith(p, end, "MemTotal:")) {
+            parseUInt(skipSpaces(p + 9, end), end, &totalKb);
+        } else if (startsWith(p, end, "MemAvailable:")) {
+            parseUInt(skipSpaces(p + 13, end), end, &availableKb);
+            break;
+        }
+    }
+    if (totalKb > 0) {
+        current[Mem] = 100.0 * (totalKb - availableKb) / totalKb;
+    }
+}
+
+void HostSampler::readPressure(ProcReader &reader, int someField, int fullField)
+{
+    if (!reader.read()) return;
+
+    // "some avg10=0.12 avg60=0.05 avg300=0.01 total=12345"
+    const char *end = reader.end();
+    for (const char *p = reader.begin(); p < end; p = nextLine(p, end)) {
+        int field = startsWith(p, end, "some ") ? someField
+                    : startsWith(p, end, "full ") ? fullField : -1;
+        if (field < 0 || !startsWith(p + 5, end, "avg10=")) continue;
+        parseFixed(p + 11, end, &current[field]);
+    }
+}
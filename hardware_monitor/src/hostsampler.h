@@ -0,0 +1,41 @@
+#ifndef HOSTSAMPLER_H
+#define HOSTSAMPLER_H
+
+#include <QStringList>
+#include <QVector>
+#include "procreader.h"
+
+// Amostrador mínimo do hwmon-agent: CPU (total e por núcleo), RAM e PSI
+// lidos com ProcReader, sem histórico, log nem varredura de processos.
+// Os nomes dos campos seguem as séries do MetricHistory.
+class HostSampler
+{
+public:
+    enum Field { Cpu, Mem, PsiCpuSome, PsiMemSome, PsiMemFull, PsiIoSome, PsiIoFull, FirstCore };
+
+    HostSampler();
+
+    // A CPU sai como delta desde a chamada anterior (a primeira só prepara)
+    void sample();
+
+    const QStringList &fieldNames() const { return fields; }
+    const QVector<double> &values() const { return current; }
+
+private:
+    void readCpu();
+    void updateCpu(const char *line, const char *end, int slot, int field);
+    void readMemory();
+    void readPressure(ProcReader &reader, int someField, int fullField);
+
+    ProcReader stat;
+    ProcReader meminfo;
+    ProcReader psiCpu;
+    ProcReader psiMemory;
+    ProcReader psiIo;
+    QVector<quint64> previousIdle;    // [0] agregado, [N + 1] "cpuN"
+    QVector<quint64> previousTotal;
+    QStringList fields;
+    QVector<double> current;
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "hoststream.h"
+#include "varint.h"
+#include <cmath>
+
+namespace {
+
+void putBytes(QByteArray &out, const QByteArray &bytes)
+{
+    putVarint(out, quint64(bytes.size()));
+    out.append(bytes);
+}
+
+bool getBytes(const char *&p, const char *end, QByteArray *bytes)
+{
+    quint64 length = getVarint(p, end);
+    if (length > quint64(end - p)) return false;
+    *bytes = QByteArray(p, int(length));
+    p += length;
+    return true;
+}
+
+}
+
+HostStreamEncoder::HostStreamEncoder(const QByteArray &hostName, const QStringList &fields)
+    : hostName(hostName), fields(fields), lastSent(fields.size(), 0),
+      lastTimestamp(0), helloSent(false)
+{
+}
+
+void HostStreamEncoder::appendFrame(QByteArray *out, const QByteArray &frame)
+{
+    putVarint(*out, quint64(frame.size()));
+    out->append(frame);
+}
+
+void HostStreamEncoder::encode(qint64 timestampMs, const QVector<double> &values, QByteArray *out)
+{
+    if (!helloSent) {
+        body.clear();
+        body.append(char(HostStream::Hello));
+        putVarint(body, HostStream::Version);
+        putBytes(body, hostName);
+        putVarint(body, quint64(fields.size()));
+        for (const QString &field : fields) {
+            putBytes(body, field.toUtf8());
+        }
+        appendFrame(out, body);
+        helloSent = true;
+    }
+
+    body.clear();
+    body.append(char(HostStream::Sample));
+    putVarint(body, zigzag(timestampMs - lastTimestamp));
+    lastTimestamp = timestampMs;
+
+    // Valor ausente (NaN) conta como inalterado
+    int count = qMin(values.size(), lastSent.size());
+    auto quantize = [&](int i) {
+        return std::isfinite(values[i]) ? qint64(std::llround(values[i] * HostStream::Scale))
+                                        : lastSent[i];
+    };
+    int changed = 0;
+    for (int i = 0; i < count; ++i) {
+        if (quantize(i) != lastSent[i]) ++changed;
+    }
+    putVarint(body, quint64(changed));
+
+    int previous = -1;
+    for (int i = 0; i < count; ++i) {
+        qint64 q = quantize(i);
+        if (q == lastSent[i]) continue;
+        putVarint(body, quint64(i - previous - 1));
+        putVarint(body, zigzag(q - lastSent[i]));
+        lastSent[i] = q;
+        previous = i;
+    }
+    appendFrame(out, body);
+}
+
+HostStreamDecoder::HostStreamDecoder()
+    : timestamp(0), samples(0), helloReceived(false)
+{
+}
+
+bool HostStreamDecoder::feed(const char *data, int size)
+{
+    pending.append(data, size);
+
+    const char *p = pending.constData();
+    const char *end = p + pending.size();
+    while (p < end) {
+        // O prefixo de tamanho também pode chegar pela metade
+        const char *q = p;
+        while (q < end && q - p < 10 && (quint8(*q) & 0x80)) ++q;
+        if (q == end) break;
+        if (q - p == 10) return false;
+
+        q = p;
+        quint64 length = getVarint(q, end);
+        if (length == 0 || length > quint64(HostStream::MaxFrameBytes)) return false;
+        if (quint64(end - q) < length) break;
+        if (!parseFrame(q, q + length)) return false;
+        p = q + length;
+    }
+
+    pending.remove(0, int(p - pending.constData()));
+    return true;
+}
+
+bool HostStreamDecoder::parseFrame(const char *p, const char *end)
+{
+    quint8 type = quint8(*p++);
+
+    if (type == HostStream::Hello) {
+        if (getVarint(p, end) != quint64(HostStream::Version)) return false;
+        if (!getBytes(p, end, &host)) return false;
+
+        quint64 count = getVarint(p, end);
+        if (count > quint64(end - p)) return false;
+        fieldNames.clear();
+        for (quint64 i = 0; i < count; ++i) {
+            QByteArray name;
+            if (!getBytes(p, end, &name)) return false;
+            fieldNames.append(QString::fromUtf8(name));
+        }
+        quantized.fill(0, fieldNames.size());
+        current.fill(0.0, fieldNames.size());
+        timestamp = 0;
+        helloReceived = true;
+        return true;
+    }
+
+    if (type == HostStream::Sample) {
+        if (!helloReceived) return false;
+        timestamp += unzigzag(getVarint(p, end));
+
+        quint64 changed = getVarint(p, end);
+        if (changed > quint64(quantized.size())) return false;
+        int index = -1;
+        for (quint64 i = 0; i < changed; ++i) {
+            index += int(getVarint(p, end)) + 1;
+            if (index < 0 || index >= quantized.size()) return false;
+            quantized[index] += unzigzag(getVarint(p, end));
+            current[index] = quantized[index] / HostStream::Scale;
+        }
+        ++samples;
+        return true;
+    }
+
+    // Tipos desconhecidos são de versões mais novas do agente: ignorados
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef HOSTSTREAM_H
+#define HOSTSTREAM_H
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+// Protocolo binário entre hwmon-agent e a interface. Cada quadro é
+// <varint tamanho><tipo><corpo>:
+//
+//   Hello   versão, nome do host, lista de campos ("cpu", "cpu_core{3}"...)
+//   Sample  Δtimestamp em ms, nº de campos alterados e, para cada um,
+//           salto de índice + Δvalor em zigzag
+//
+// Os valores viajam em centésimos (percentuais e PSI), e só os campos cujo
+// valor quantizado mudou desde o último quadro são enviados. Com o
+// transporte confiável (TCP ou pipe) não há quadros completos periódicos:
+// cada conexão começa do zero com um Hello.
+namespace HostStream {
+enum FrameType : quint8 { Hello = 1, Sample = 2 };
+constexpr int Version = 1;
+constexpr double Scale = 100.0;
+constexpr int MaxFrameBytes = 1 << 20;
+}
+
+class HostStreamEncoder
+{
+public:
+    HostStreamEncoder(const QByteArray &hostName, const QStringList &fields);
+
+    // Acrescenta os quadros a out; o primeiro encode() já inclui o Hello
+    void encode(qint64 timestampMs, const QVector<double> &values, QByteArray *out);
+
+private:
+    void appendFrame(QByteArray *out, const QByteArray &frame);
+
+    QByteArray hostName;
+    QStringList fields;
+    QVector<qint64> lastSent;
+    qint64 lastTimestamp;
+    bool helloSent;
+    QByteArray body;            // reaproveitado entre quadros
+};
+
+class HostStreamDecoder
+{
+public:
+    HostStreamDecoder();
+
+    // Consome bytes recebidos, em qualquer fatiamento; false em erro de
+    // protocolo (a conexão deve ser descartada)
+    bool feed(const char *data, int size);
+
+    bool hasHello() const { return helloReceived; }
+    QByteArray hostName() const { return host; }
+    const QStringList &fields() const { return fieldNames; }
+    const QVector<double> &values() const { return current; }
+    qint64 timestampMs() const { return timestamp; }
+    // Quantidade de amostras decodificadas desde a criação
+    quint64 sampleCount() const { return samples; }
+
+private:
+    bool parseFrame(const char *p, const char *end);
+
+    QByteArray pending;
+    QByteArray host;
+    QStringList fieldNames;
+    QVector<qint64> quantized;
+    QVector<double> current;
+    qint64 timestamp;
+    quint64 samples;
+    bool helloReceived;
+};
+
+#endif
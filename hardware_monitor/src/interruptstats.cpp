@@ -0,0 +1,158 @@
+#include "interruptstats.h"
+#include <cstring>
+
+IrqMatrix::IrqMatrix()
+    : rowCount(0), cpuCount(0), changed(false)
+{
+}
+
+void IrqMatrix::resize(int newRows, int newCpus)
+{
+    if (newCpus != cpuCount) {
+        // Com outra largura as células antigas não batem mais
+        counts.fill(0, 0);
+        previous.fill(0, 0);
+        changed = true;
+    }
+    cpuCount = newCpus;
+    if (newRows > labels.size()) {
+        labels.resize(newRows);
+        totals.resize(newRows);
+    }
+    counts.resize(newRows * cpuCount);
+    previous.resize(newRows * cpuCount);
+    rates.resize(newRows * cpuCount);
+}
+
+bool IrqMatrix::parseRow(const char *&p, const char *end, int row)
+{
+    // "  24:   1234   5678   PCI-MSI 524288-edge   eth0-TxRx-0"
+    p = skipSpaces(p, end);
+    const char *labelStart = p;
+    while (p < end && *p != ':' && *p != '\n') ++p;
+    if (p >= end || *p != ':') {
+        p = nextLine(p, end);
+        return false;
+    }
+    const char *labelEnd = p++;
+
+    // labels e totals só crescem (os rótulos guardados são reaproveitados),
+    // mas as células acompanham a última contagem de linhas: o teste tem
+    // que ser sobre counts, senão uma IRQ que some e volta escreve fora
+    if (row >= labels.size() || (row + 1) * cpuCount > counts.size()) {
+        resize(row + 1, cpuCount);
+    }
+
+    quint64 *cells = counts.data() + row * cpuCount;
+    quint64 sum = 0;
+    int cpu = 0;
+    for (; cpu < cpuCount; ++cpu) {
+        p = skipSpaces(p, end);
+        quint64 value = 0;
+        const char *next = parseUInt(p, end, &value);
+        if (next == p) break; // ERR/MIS trazem uma coluna só
+        cells[cpu] = value;
+        sum += value;
+        p = next;
+    }
+    for (; cpu < cpuCount; ++cpu) {
+        cells[cpu] = 0;
+    }
+
+    // O rótulo inclui a descrição final (ex.: "24 eth0-TxRx-0") para
+    // identificar a placa; a descrição só muda quando a IRQ muda de dono.
+    p = skipSpaces(p, end);
+    const char *lineEnd = p;
+    while (lineEnd < end && *lineEnd != '\n') ++lineEnd;
+    const char *descStart = lineEnd;
+    while (descStart > p && descStart[-1] != ' ') --descStart;
+
+    int labelLength = labelEnd - labelStart;
+    int descLength = lineEnd - descStart;
+    QByteArray &stored = labels[row];
+    int storedLength = labelLength + (descLength ? descLength + 1 : 0);
+    bool same = stored.size() == storedLength
+                && std::memcmp(stored.constData(), labelStart, labelLength) == 0
+                && (!descLength || std::memcmp(stored.constData() + labelLength + 1, descStart, descLength) == 0);
+    if (!same) {
+        stored = QByteArray(labelStart, labelLength);
+        if (descLength) {
+            stored.append(' ');
+            stored.append(descStart, descLength);
+        }
+        changed = true;
+    }
+
+    totals[row] = sum;
+    p = nextLine(lineEnd, end);
+    return true;
+}
+
+bool IrqMatrix::parse(const char *p, const char *end)
+{
+    changed = false;
+
+    // Cabeçalho: "   CPU0   CPU1 ..." define a largura da matriz
+    int cpus = 0;
+    const char *header = p;
+    p = nextLine(p, end);
+    for (const char *h = header; h + 3 < p; ++h) {
+        if (h[0] == 'C' && h[1] == 'P' && h[2] == 'U') ++cpus;
+    }
+    if (cpus == 0) return false;
+
+    if (cpus != cpuCount) {
+        resize(rowCount, cpus);
+    }
+
+    int row = 0;
+    while (p < end) {
+        if (parseRow(p, end, row)) ++row;
+    }
+
+    if (row != rowCount) {
+        changed = true;
+        rowCount = row;
+        resize(rowCount, cpuCount);
+    }
+    return true;
+}
+
+void IrqMatrix::computeRates(double seconds)
+{
+    const int cells = rowCount * cpuCount;
+    const quint64 *cur = counts.constData();
+    quint64 *prev = previous.data();
+    float *out = rates.data();
+    const float scale = seconds > 0.0 ? float(1.0 / seconds) : 0.0f;
+
+    // Laço simples sobre arrays contíguos: o compilador vetoriza
+    for (int i = 0; i < cells; ++i) {
+        quint64 delta = cur[i] >= prev[i] ? cur[i] - prev[i] : 0;
+        out[i] = float(delta) * scale;
+    }
+    std::memcpy(prev, cur, cells * sizeof(quint64));
+
+    if (changed) {
+        // Linhas novas ou realocadas não têm base para a taxa
+        for (int i = 0; i < cells; ++i) out[i] = 0.0f;
+    }
+}
+
+InterruptStats::InterruptStats()
+    : interruptsFile("/proc/interrupts"), softirqsFile("/proc/softirqs")
+{
+}
+
+void InterruptStats::sample()
+{
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+
+    if (interruptsFile.read() && irqs.parse(interruptsFile.begin(), interruptsFile.end())) {
+        irqs.computeRates(seconds);
+    }
+    if (softirqsFile.read() && soft.parse(softirqsFile.begin(), softirqsFile.end())) {
+        soft.computeRates(seconds);
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef INTERRUPTSTATS_H
+#define INTERRUPTSTATS_H
+
+#include <QByteArray>
+#include <QVector>
+#include <QElapsedTimer>
+#include "procreader.h"
+
+// Matriz IRQ x CPU de um arquivo no formato de /proc/interrupts: contadores
+// acumulados do tick atual e do anterior em arrays contíguos pré-alocados,
+// mais a taxa por segundo de cada célula.
+class IrqMatrix
+{
+public:
+    IrqMatrix();
+
+    int rows() const { return rowCount; }
+    int cpus() const { return cpuCount; }
+    const QByteArray &label(int row) const { return labels[row]; }
+    float rate(int row, int cpu) const { return rates[row * cpuCount + cpu]; }
+    quint64 total(int row) const { return totals[row]; }
+
+    // Mudou a lista de IRQs ou de CPUs desde o último parse
+    bool structureChanged() const { return changed; }
+
+    bool parse(const char *p, const char *end);
+    void computeRates(double seconds);
+
+private:
+    void resize(int newRows, int newCpus);
+    bool parseRow(const char *&p, const char *end, int row);
+
+    int rowCount;
+    int cpuCount;
+    bool changed;
+    QVector<QByteArray> labels;
+    QVector<quint64> counts;
+    QVector<quint64> previous;
+    QVector<float> rates;
+    QVector<quint64> totals;
+};
+
+class InterruptStats
+{
+public:
+    InterruptStats();
+
+    void sample();
+
+    const IrqMatrix &interrupts() const { return irqs; }
+    const IrqMatrix &softirqs() const { return soft; }
+
+private:
+    ProcReader interruptsFile;
+    ProcReader softirqsFile;
+    IrqMatrix irqs;
+    IrqMatrix soft;
+    QElapsedTimer clock;
+};
+
+#endif
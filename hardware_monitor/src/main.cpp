@@ -1,10 +1,23 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include "mainwindow.h"
+#include "startupprofile.h"
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption profileOption("profile-startup",
+                                     "Mostra no stderr o tempo de cada fase da inicialização");
+    parser.addOption(profileOption);
+    parser.process(app);
+    if (parser.isSet(profileOption)) {
+        StartupProfile::enable();
+        StartupProfile::mark("QApplication criada");
+    }
+
     MainWindow window;
     window.show();
 
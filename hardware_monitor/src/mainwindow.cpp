@@ -2,32 +2,104 @@
 #include <QWidget>
 #include <QFont>
 #include <QApplication>
+#include <QEvent>
+#include <QScrollArea>
+#include <QtAlgorithms>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QDateTime>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QSet>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include "startupprofile.h"
+
+namespace {
+
+QString hostsFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/hosts.ini";
+}
+
+// Últimos valores da sessão anterior, para a primeira pintura
+QString startupCacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/startup.ini";
+}
+
+}
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent)
+    : QMainWindow(parent), cgroupGeneration(~0u), historyLog(nullptr), exporter(nullptr),
+      painted(false), diskGeneration(~0u)
 {
     setWindowTitle("Monitor de Hardware");
-    setFixedSize(500, 300);
+    resize(560, 480);
 
-    sysInfo = new SystemInfo(this);
+    sysInfo = SystemInfo::instance();
     connect(sysInfo, &SystemInfo::statsUpdated, this, &MainWindow::updateDisplay);
+    connect(sysInfo, &SystemInfo::anomalyChanged, this, &MainWindow::onAnomalyChanged);
+    connect(sysInfo, &SystemInfo::interruptsUpdated, this, &MainWindow::updateInterrupts);
+    connect(sysInfo, &SystemInfo::filesystemsUpdated, this, &MainWindow::updateFilesystems);
+    connect(sysInfo, &SystemInfo::processesUpdated, this, &MainWindow::updateProcesses);
+    connect(sysInfo, &SystemInfo::cgroupsUpdated, this, &MainWindow::updateCgroups);
+    connect(sysInfo, &SystemInfo::socketsUpdated, this, &MainWindow::updateSockets);
 
     setupUI();
 
-    cpuModelLabel->setText("CPU: " + sysInfo->getCpuModel());
-    ramSizeLabel->setText("RAM: " + sysInfo->getRamInfo());
+    // Nada de /proc/cpuinfo aqui: a janela aparece com os valores da sessão
+    // anterior e o hardware é lido depois da primeira pintura
+    loadStartupCache();
+
+    // A aba inicial (visão geral) não precisa de coletor extra
+    sysInfo->subscribe(this, 0);
+    StartupProfile::mark("janela construída");
 }
 
 MainWindow::~MainWindow()
 {
+    Snapshot last = sysInfo->getSnapshot();
+    if (last.isValid()) {
+        QSettings cache(startupCacheFile(), QSettings::IniFormat);
+        cache.setValue("cpuUsage", last.cpuUsage());
+        cache.setValue("memUsage", last.memUsage());
+    }
+
+    delete exporter;
+    delete historyLog;
+}
+
+void MainWindow::loadStartupCache()
+{
+    QSettings cache(startupCacheFile(), QSettings::IniFormat);
+    cpuModelLabel->setText("CPU: " + cache.value("cpuModel", "...").toString());
+    ramSizeLabel->setText("RAM: " + cache.value("ramInfo", "...").toString());
+    if (cache.contains("cpuUsage")) {
+        showUsage(cache.value("cpuUsage").toDouble(), cache.value("memUsage").toDouble());
+    }
+}
+
+void MainWindow::loadHardwareInfo()
+{
+    QString cpuModel = sysInfo->getCpuModel();
+    QString ramInfo = sysInfo->getRamInfo();
+    cpuModelLabel->setText("CPU: " + cpuModel);
+    ramSizeLabel->setText("RAM: " + ramInfo);
+
+    QSettings cache(startupCacheFile(), QSettings::IniFormat);
+    cache.setValue("cpuModel", cpuModel);
+    cache.setValue("ramInfo", ramInfo);
 }
 
 void MainWindow::setupUI()
 {
-    QWidget *centralWidget = new QWidget(this);
-    setCentralWidget(centralWidget);
+    tabs = new QTabWidget(this);
+    setCentralWidget(tabs);
 
-    QVBoxLayout *mainLayout = new QVBoxLayout(centralWidget);
+    QWidget *overviewTab = new QWidget();
+    QVBoxLayout *mainLayout = new QVBoxLayout(overviewTab);
 
     QGroupBox *hardwareBox = new QGroupBox("Informações do Hardware");
     QVBoxLayout *hardwareLayout = new QVBoxLayout(hardwareBox);
@@ -61,21 +133,919 @@ void MainWindow::setupUI()
     memLayout->addWidget(memUsageLabel);
     memLayout->addWidget(memProgressBar);
 
+    anomalyLabel = new QLabel();
+    anomalyLabel->setStyleSheet("color: #c62828; font-weight: bold;");
+    anomalyLabel->hide();
+
     usageLayout->addLayout(cpuLayout);
     usageLayout->addLayout(memLayout);
 
+    // Uma barra por sistema de arquivos local, logo abaixo da RAM
+    diskLayout = new QVBoxLayout();
+    usageLayout->addLayout(diskLayout);
+    usageLayout->addWidget(anomalyLabel);
+
+    QGroupBox *percentileBox = new QGroupBox("Percentis p50 / p95 / p99");
+    QGridLayout *percentileLayout = new QGridLayout(percentileBox);
+
+    const char *windowNames[] = { "1 min", "1 h", "24 h" };
+    const char *rowNames[] = { "CPU", "RAM", "Núcleos" };
+    for (int w = 0; w < MetricHistory::WindowCount; ++w) {
+        percentileLayout->addWidget(new QLabel(windowNames[w]), 0, w + 1);
+    }
+    for (int r = 0; r < 3; ++r) {
+        percentileLayout->addWidget(new QLabel(rowNames[r]), r + 1, 0);
+        for (int w = 0; w < MetricHistory::WindowCount; ++w) {
+            percentileLabels[r][w] = new QLabel("-");
+            percentileLayout->addWidget(percentileLabels[r][w], r + 1, w + 1);
+        }
+    }
+
     mainLayout->addWidget(hardwareBox);
     mainLayout->addWidget(usageBox);
+    mainLayout->addWidget(percentileBox);
     mainLayout->addStretch();
+
+    tabs->addTab(overviewTab, "Visão geral");
+    tabs->addTab(createInterruptsTab(), "Interrupções");
+    tabs->addTab(createSchedulerTab(), "Escalonador");
+    tabs->addTab(createProcessesTab(), "Processos");
+    tabs->addTab(createCgroupsTab(), "Cgroups");
+    tabs->addTab(createSocketsTab(), "Sockets");
+    tabs->addTab(createHistoryTab(), "Histórico");
+    tabs->addTab(createQueriesTab(), "Consultas");
+    tabs->addTab(createDiffTab(), "Diferenças");
+    tabs->addTab(createHostsTab(), "Hosts");
+    connect(tabs, &QTabWidget::currentChanged, this, &MainWindow::onTabChanged);
+}
+
+QWidget *MainWindow::createInterruptsTab()
+{
+    QWidget *content = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(content);
+
+    QGroupBox *irqBox = new QGroupBox("IRQs por CPU (eventos/s)");
+    QVBoxLayout *irqLayout = new QVBoxLayout(irqBox);
+    irqHeatmap = new HeatmapWidget();
+    irqLayout->addWidget(irqHeatmap);
+
+    QGroupBox *softirqBox = new QGroupBox("Softirqs por CPU (eventos/s)");
+    QVBoxLayout *softirqLayout = new QVBoxLayout(softirqBox);
+    softirqHeatmap = new HeatmapWidget();
+    softirqLayout->addWidget(softirqHeatmap);
+
+    layout->addWidget(irqBox);
+    layout->addWidget(softirqBox);
+    layout->addStretch();
+
+    interruptsTab = new QScrollArea();
+    interruptsTab->setWidget(content);
+    interruptsTab->setWidgetResizable(true);
+    return interruptsTab;
+}
+
+QWidget *MainWindow::createSchedulerTab()
+{
+    schedTree = new QTreeWidget();
+    schedTree->setRootIsDecorated(false);
+    schedTree->setHeaderLabels(QStringList() << "CPU" << "Executando %" << "Espera na fila (ms/s)"
+                                             << "Timeslices/s" << "Espera por timeslice (µs)"
+                                             << "IPC" << "GHz" << "Cache misses/kinstr"
+                                             << "Trocas de contexto/s");
+    return schedTree;
+}
+
+QWidget *MainWindow::createProcessesTab()
+{
+    // Modelo incremental: a view só recebe inserções, remoções e
+    // dataChanged das linhas que mudaram, nunca um reset
+    processModel = new ProcessModel(&sysInfo->getProcessStats().strings(), this);
+    processView = new QTreeView();
+    processView->setModel(processModel);
+    processView->setUniformRowHeights(true);
+    processView->setAlternatingRowColors(true);
+
+    // Rotatividade que a varredura não vê: processos que nascem e morrem
+    // entre dois ticks
+    churnLabel = new QLabel();
+    churnLabel->setWordWrap(true);
+
+    processesTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(processesTab);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(churnLabel);
+    layout->addWidget(processView);
+    return processesTab;
+}
+
+QWidget *MainWindow::createCgroupsTab()
+{
+    cgroupTree = new QTreeWidget();
+    cgroupTree->setHeaderLabels(QStringList() << "Cgroup" << "CPU %" << "Memória (MB)"
+                                              << "Leitura (MB/s)" << "Escrita (MB/s)");
+    cgroupTree->setUniformRowHeights(true);
+    return cgroupTree;
+}
+
+QWidget *MainWindow::createSocketsTab()
+{
+    socketTree = new QTreeWidget();
+    socketTree->setRootIsDecorated(false);
+    socketTree->setHeaderLabels(QStringList() << "Métrica" << "Valor");
+    return socketTree;
+}
+
+QWidget *MainWindow::createHistoryTab()
+{
+    historyTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(historyTab);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    QPushButton *openButton = new QPushButton("Abrir...");
+    historyPathLabel = new QLabel();
+    exportButton = new QPushButton("Exportar...");
+    top->addWidget(openButton);
+    top->addWidget(historyPathLabel, 1);
+    top->addWidget(exportButton);
+
+    QHBoxLayout *body = new QHBoxLayout();
+    historySeriesList = new QListWidget();
+    historySeriesList->setMaximumWidth(180);
+    historyView = new HistoryView();
+    body->addWidget(historySeriesList);
+    body->addWidget(historyView, 1);
+
+    QLabel *hint = new QLabel("Roda do mouse: zoom · arrastar: mover · duplo clique: tudo");
+    exportStatus = new QLabel();
+    layout->addLayout(top);
+    layout->addLayout(body, 1);
+    layout->addWidget(hint);
+    layout->addWidget(exportStatus);
+
+    connect(openButton, &QPushButton::clicked, this, &MainWindow::openHistory);
+    connect(exportButton, &QPushButton::clicked, this, &MainWindow::exportHistory);
+    connect(historySeriesList, &QListWidget::itemChanged, this, &MainWindow::onHistorySeriesChanged);
+    return historyTab;
+}
+
+void MainWindow::loadHistory(const QString &directory)
+{
+    delete historyLog;
+    historyLog = new MetricLog(directory);
+    historyPathLabel->setText(directory);
+    historyView->setLog(historyLog);
+    historySeriesList->clear();
+    refreshHistorySeries();
+    onHistorySeriesChanged();
+    historyView->resetRange();
+}
+
+void MainWindow::refreshHistorySeries()
+{
+    // Séries criadas pelo gravador depois da abertura entram no fim da lista
+    historyLog->reload();
+    QStringList keys = historyLog->seriesKeys();
+    historySeriesList->blockSignals(true);
+    for (int i = historySeriesList->count(); i < keys.size(); ++i) {
+        QListWidgetItem *item = new QListWidgetItem(keys[i], historySeriesList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(keys[i] == "cpu" ? Qt::Checked : Qt::Unchecked);
+    }
+    historySeriesList->blockSignals(false);
+}
+
+void MainWindow::openHistory()
+{
+    QString start = historyLog ? historyLog->directory() : MetricLog::defaultDirectory();
+    QString directory = QFileDialog::getExistingDirectory(this, "Abrir histórico gravado", start);
+    if (!directory.isEmpty()) {
+        loadHistory(directory);
+    }
+}
+
+void MainWindow::onHistorySeriesChanged()
+{
+    QVector<int> selected;
+    for (int i = 0; i < historySeriesList->count(); ++i) {
+        if (historySeriesList->item(i)->checkState() == Qt::Checked) {
+            selected.append(i);
+        }
+    }
+    historyView->setSeries(selected);
+}
+
+void MainWindow::exportHistory()
+{
+    // Durante uma exportação o botão vira "Cancelar"
+    if (exporter) {
+        exporter->cancel();
+        return;
+    }
+
+    QStringList keys;
+    for (int i = 0; i < historySeriesList->count(); ++i) {
+        if (historySeriesList->item(i)->checkState() == Qt::Checked) {
+            keys << historySeriesList->item(i)->text();
+        }
+    }
+    if (keys.isEmpty() || !historyLog) {
+        exportStatus->setText("Marque ao menos uma série para exportar");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, "Exportar intervalo visível", QString(),
+                                                "CSV (*.csv);;Colunar compactado (*.hwcol)");
+    if (path.isEmpty()) return;
+
+    exporter = new HistoryExporter(historyLog->directory(), keys, historyView->rangeFrom(),
+                                   historyView->rangeTo(), path);
+    connect(exporter, &HistoryExporter::progress, this, [this](qint64 rows, int percent) {
+        exportStatus->setText(QString("Exportando... %1 linhas (%2%)").arg(rows).arg(percent));
+    });
+    connect(exporter, &HistoryExporter::finished, this, &MainWindow::onExportFinished);
+    exportButton->setText("Cancelar");
+    exportStatus->setText("Exportando...");
+    exporter->start();
+}
+
+void MainWindow::onExportFinished(bool ok, const QString &error)
+{
+    exportStatus->setText(ok ? "Exportação concluída" : "Exportação falhou: " + error);
+    exportButton->setText("Exportar...");
+    exporter->deleteLater();
+    exporter = nullptr;
+}
+
+QWidget *MainWindow::createQueriesTab()
+{
+    QWidget *tab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    queryEdit = new QLineEdit();
+    queryEdit->setPlaceholderText("ex.: max by core(cpu_core[1h]) ou rate(disk_read_bytes[1m]) > 1e8");
+    QPushButton *addButton = new QPushButton("Adicionar");
+    QPushButton *removeButton = new QPushButton("Remover");
+    top->addWidget(queryEdit, 1);
+    top->addWidget(addButton);
+    top->addWidget(removeButton);
+
+    queryError = new QLabel();
+    queryError->setStyleSheet("color: #c62828;");
+    queryError->hide();
+
+    queryTree = new QTreeWidget();
+    queryTree->setRootIsDecorated(false);
+    queryTree->setHeaderLabels(QStringList() << "Expressão" << "Resultado");
+
+    layout->addLayout(top);
+    layout->addWidget(queryError);
+    layout->addWidget(queryTree, 1);
+
+    connect(addButton, &QPushButton::clicked, this, &MainWindow::addQuery);
+    connect(queryEdit, &QLineEdit::returnPressed, this, &MainWindow::addQuery);
+    connect(removeButton, &QPushButton::clicked, this, &MainWindow::removeQuery);
+    return tab;
+}
+
+void MainWindow::addQuery()
+{
+    // Compila uma vez; a cada tick só o plano é executado
+    MetricQuery query(queryEdit->text(), sysInfo->getHistorySpanMs());
+    if (!query.isValid()) {
+        queryError->setText(query.errorString());
+        queryError->show();
+        return;
+    }
+
+    queryError->hide();
+    queryEdit->clear();
+    queries.append(query);
+    queryTree->addTopLevelItem(new QTreeWidgetItem(QStringList() << query.text() << "-"));
+    updateQueries();
+}
+
+void MainWindow::removeQuery()
+{
+    QTreeWidgetItem *item = queryTree->currentItem();
+    if (!item) return;
+    queries.remove(queryTree->indexOfTopLevelItem(item));
+    delete item;
+}
+
+void MainWindow::updateQueries()
+{
+    const MetricHistory &history = sysInfo->getHistory();
+    for (int i = 0; i < queries.size(); ++i) {
+        QVector<QueryValue> values = queries[i].evaluate(history);
+
+        QStringList parts;
+        for (const QueryValue &value : values) {
+            QString number = QString::number(value.value, 'g', 4);
+            parts.append(value.label.isEmpty() ? number : QString("%1: %2").arg(value.label, number));
+        }
+
+        // Condição satisfeita (resultado não vazio) fica em destaque
+        QTreeWidgetItem *item = queryTree->topLevelItem(i);
+        if (parts.isEmpty()) {
+            parts.append(queries[i].wasTruncated() ? QString("janela além do histórico") : QString("-"));
+        }
+        item->setText(1, parts.join("  "));
+        bool firing = queries[i].isCondition() && !values.isEmpty();
+        item->setForeground(1, firing ? QBrush(QColor(198, 40, 40)) : QBrush());
+    }
+}
+
+QWidget *MainWindow::createDiffTab()
+{
+    diffTab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(diffTab);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    diffFromCombo = new QComboBox();
+    diffToCombo = new QComboBox();
+    QPushButton *compareButton = new QPushButton("Comparar");
+    top->addWidget(new QLabel("De:"));
+    top->addWidget(diffFromCombo, 1);
+    top->addWidget(new QLabel("Até:"));
+    top->addWidget(diffToCombo, 1);
+    top->addWidget(compareButton);
+
+    diffTree = new QTreeWidget();
+    diffTree->setHeaderLabels(QStringList() << "Item" << "Antes" << "Depois");
+
+    layout->addLayout(top);
+    layout->addWidget(diffTree, 1);
+
+    connect(compareButton, &QPushButton::clicked, this, &MainWindow::compareSnapshots);
+    return diffTab;
+}
+
+void MainWindow::refreshSnapshotTimes()
+{
+    // Snapshots novos entram no fim; os descartados saem do começo
+    const SnapshotHistory &snapshots = sysInfo->getSnapshotHistory();
+    qint64 from = diffFromCombo->currentData().toLongLong();
+    qint64 to = diffToCombo->currentData().toLongLong();
+    bool following = diffToCombo->currentIndex() == diffToCombo->count() - 1;
+
+    diffFromCombo->clear();
+    diffToCombo->clear();
+    for (int i = 0; i < snapshots.size(); ++i) {
+        qint64 ts = snapshots.timestampAt(i);
+        QString text = QDateTime::fromMSecsSinceEpoch(ts).toString("dd/MM HH:mm");
+        diffFromCombo->addItem(text, ts);
+        diffToCombo->addItem(text, ts);
+    }
+    if (snapshots.size() == 0) return;
+
+    diffFromCombo->setCurrentIndex(from ? snapshots.indexNear(from) : 0);
+    diffToCombo->setCurrentIndex(to && !following ? snapshots.indexNear(to) : snapshots.size() - 1);
+}
+
+void MainWindow::compareSnapshots()
+{
+    const SnapshotHistory &snapshots = sysInfo->getSnapshotHistory();
+    int from = snapshots.indexNear(diffFromCombo->currentData().toLongLong());
+    int to = snapshots.indexNear(diffToCombo->currentData().toLongLong());
+    diffTree->clear();
+    if (from < 0 || to < 0) return;
+
+    SnapshotDiff diff = diffSnapshots(snapshots.snapshotAt(from), snapshots.snapshotAt(to));
+
+    auto category = [this](const QString &title, int count) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(diffTree);
+        item->setText(0, QString("%1 (%2)").arg(title).arg(count));
+        item->setExpanded(count > 0 && count <= SnapshotDiff::MaxGrowthRows);
+        return item;
+    };
+    auto processText = [](const SnapshotProcess &p) {
+        return QString("%1 %2").arg(p.pid).arg(QString::fromUtf8(p.name));
+    };
+
+    QTreeWidgetItem *appeared = category("Processos novos", diff.appeared.size());
+    for (const SnapshotProcess &p : diff.appeared) {
+        new QTreeWidgetItem(appeared, QStringList() << processText(p) << QString()
+                                      << QString("%1 MB").arg(p.rssKb / 1024));
+    }
+    QTreeWidgetItem *disappeared = category("Processos encerrados", diff.disappeared.size());
+    for (const SnapshotProcess &p : diff.disappeared) {
+        new QTreeWidgetItem(disappeared, QStringList() << processText(p)
+                                         << QString("%1 MB").arg(p.rssKb / 1024));
+    }
+    QTreeWidgetItem *rss = category("Maior crescimento de RSS", diff.rssGrowth.size());
+    for (const SnapshotDiff::Growth &g : diff.rssGrowth) {
+        new QTreeWidgetItem(rss, QStringList() << processText(g.after)
+                                 << QString("%1 MB").arg(g.before.rssKb / 1024)
+                                 << QString("%1 MB").arg(g.after.rssKb / 1024));
+    }
+    QTreeWidgetItem *cpu = category("Maior uso de CPU", diff.cpuUsage.size());
+    for (const SnapshotDiff::Growth &g : diff.cpuUsage) {
+        new QTreeWidgetItem(cpu, QStringList() << processText(g.after) << QString()
+                                 << QString("%1%").arg(g.cpuPercent, 0, 'f', 1));
+    }
+
+    auto items = [&](const QString &title, const QVector<SnapshotDiff::ItemChange> &changes) {
+        QTreeWidgetItem *parent = category(title, changes.size());
+        for (const SnapshotDiff::ItemChange &c : changes) {
+            new QTreeWidgetItem(parent, QStringList() << QString::fromUtf8(c.key)
+                                        << QString::fromUtf8(c.before)
+                                        << QString::fromUtf8(c.after));
+        }
+    };
+    items("Montagens", diff.mounts);
+    items("Interfaces", diff.interfaces);
+    items("Limites de cgroup", diff.cgroupLimits);
+}
+
+QWidget *MainWindow::createHostsTab()
+{
+    QWidget *tab = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(tab);
+
+    QHBoxLayout *top = new QHBoxLayout();
+    hostEdit = new QLineEdit();
+    hostEdit->setPlaceholderText("host:porta ou comando, ex.: ssh servidor hwmon-agent --stdio");
+    QPushButton *addButton = new QPushButton("Adicionar");
+    QPushButton *removeButton = new QPushButton("Remover");
+    top->addWidget(hostEdit, 1);
+    top->addWidget(addButton);
+    top->addWidget(removeButton);
+
+    hostTree = new QTreeWidget();
+    hostTree->setRootIsDecorated(false);
+    hostTree->setHeaderLabels(QStringList() << "Host" << "Estado" << "CPU" << "RAM"
+                                            << "PSI io" << "Núcleos" << "B/s");
+
+    layout->addLayout(top);
+    layout->addWidget(hostTree, 1);
+
+    connect(addButton, &QPushButton::clicked, this, &MainWindow::addHost);
+    connect(hostEdit, &QLineEdit::returnPressed, this, &MainWindow::addHost);
+    connect(removeButton, &QPushButton::clicked, this, &MainWindow::removeHost);
+
+    QSettings settings(hostsFile(), QSettings::IniFormat);
+    for (const QString &target : settings.value("remoteHosts").toStringList()) {
+        addRemoteHost(target);
+    }
+    return tab;
 }
 
-void MainWindow::updateDisplay(double cpuUsage, double memUsage)
+void MainWindow::addHost()
 {
-    cpuUsageLabel->setText(QString("CPU: %1%").arg(cpuUsage, 0, 'f', 1));
-    cpuProgressBar->setValue((int)cpuUsage);
+    QString target = hostEdit->text().trimmed();
+    if (target.isEmpty()) return;
+    hostEdit->clear();
+    addRemoteHost(target);
+    saveHosts();
+}
+
+void MainWindow::removeHost()
+{
+    QTreeWidgetItem *item = hostTree->currentItem();
+    if (!item) return;
+    int row = hostTree->indexOfTopLevelItem(item);
+    delete remoteHosts.takeAt(row);
+    delete item;
+    saveHosts();
+}
+
+void MainWindow::addRemoteHost(const QString &target)
+{
+    RemoteHost *host = new RemoteHost(target, this);
+    remoteHosts.append(host);
+    hostTree->addTopLevelItem(new QTreeWidgetItem(QStringList() << target));
+    connect(host, &RemoteHost::updated, this, [this, host]() { updateRemoteHost(host); });
+    connect(host, &RemoteHost::stateChanged, this, [this, host]() { updateRemoteHost(host); });
+    updateRemoteHost(host);
+}
+
+void MainWindow::updateRemoteHost(RemoteHost *host)
+{
+    int row = remoteHosts.indexOf(host);
+    if (row < 0) return;
+    QTreeWidgetItem *item = hostTree->topLevelItem(row);
+    const HostStreamDecoder &stream = host->stream();
+
+    item->setText(0, stream.hasHello()
+                     ? QString("%1 (%2)").arg(QString::fromUtf8(stream.hostName()), host->target())
+                     : host->target());
+    switch (host->state()) {
+    case RemoteHost::Connecting: item->setText(1, "conectando"); break;
+    case RemoteHost::Connected: item->setText(1, "conectado"); break;
+    case RemoteHost::Disconnected: item->setText(1, "desconectado: " + host->errorString()); break;
+    }
+    if (!stream.hasHello()) return;
+
+    auto field = [&stream](const char *name) {
+        int i = stream.fields().indexOf(name);
+        return i < 0 ? QString("-") : QString("%1%").arg(stream.values()[i], 0, 'f', 1);
+    };
+    item->setText(2, field("cpu"));
+    item->setText(3, field("mem"));
+    item->setText(4, field("psi_io_some"));
+    item->setText(5, QString::number(stream.fields().filter("cpu_core{").size()));
+    item->setText(6, QString::number(host->bytesPerSecond(), 'f', 0));
+}
+
+void MainWindow::saveHosts()
+{
+    QStringList targets;
+    for (RemoteHost *host : remoteHosts) {
+        targets << host->target();
+    }
+    QSettings(hostsFile(), QSettings::IniFormat).setValue("remoteHosts", targets);
+}
+
+void MainWindow::updateScheduler()
+{
+    const SchedStats &sched = sysInfo->getSchedStats();
+    if (!sched.isAvailable()) {
+        if (schedTree->topLevelItemCount() == 0) {
+            schedTree->addTopLevelItem(new QTreeWidgetItem(QStringList() << "/proc/schedstat indisponível"));
+        }
+        return;
+    }
+
+    // Uma linha por CPU mais o total; os itens são criados uma vez só
+    int rows = sched.cpus() + 1;
+    while (schedTree->topLevelItemCount() < rows) {
+        schedTree->addTopLevelItem(new QTreeWidgetItem());
+    }
+
+    for (int i = 0; i < rows; ++i) {
+        bool isTotal = i == sched.cpus();
+        CpuSchedRates r = isTotal ? sched.total() : sched.cpu(i);
+        double waitPerSlice = r.slicesPerSec > 0 ? r.waitMsPerSec * 1000.0 / r.slicesPerSec : 0.0;
+
+        QTreeWidgetItem *item = schedTree->topLevelItem(i);
+        item->setText(0, isTotal ? QString("Total") : QString::number(i));
+        item->setText(1, QString::number(r.runPercent, 'f', 1));
+        item->setText(2, QString::number(r.waitMsPerSec, 'f', 1));
+        item->setText(3, QString::number(r.slicesPerSec, 'f', 0));
+        item->setText(4, QString::number(waitPerSlice, 'f', 1));
+        updatePerfColumns(item, isTotal ? -1 : i);
+    }
+}
+
+void MainWindow::updatePerfColumns(QTreeWidgetItem *item, int cpu)
+{
+    const PerfCounters &perf = sysInfo->getPerfCounters();
+    if (!perf.isOpen() || cpu >= perf.cpus()) {
+        for (int column = 5; column <= 8; ++column) {
+            item->setText(column, "—");
+        }
+        return;
+    }
+
+    CpuPerfRates r = cpu < 0 ? perf.total() : perf.cpu(cpu);
+    bool hardware = perf.currentMode() == PerfCounters::Hardware;
+    item->setText(5, hardware ? QString::number(r.ipc, 'f', 2) : QString("—"));
+    item->setText(6, hardware ? QString::number(r.ghz, 'f', 2) : QString("—"));
+    item->setText(7, hardware ? QString::number(r.missesPerKiloInstr, 'f', 1) : QString("—"));
+    item->setText(8, QString::number(r.contextSwitchesPerSec, 'f', 0));
+}
+
+void MainWindow::updatePerfStatus()
+{
+    // Explica as colunas vazias: sem PMU (VM) ou perf_event_paranoid restritivo
+    const PerfCounters &perf = sysInfo->getPerfCounters();
+    QString status;
+    if (perf.currentMode() == PerfCounters::Software) {
+        status = "Contadores de hardware indisponíveis; só eventos de software";
+    } else if (perf.currentMode() == PerfCounters::Unavailable) {
+        int level = 0;
+        status = PerfCounters::paranoidLevel(&level)
+                     ? QString("perf_event indisponível (%1, kernel.perf_event_paranoid = %2)")
+                           .arg(QString::fromLocal8Bit(strerror(perf.lastError()))).arg(level)
+                     : QString("perf_event indisponível");
+    }
+    for (int column = 5; column <= 8; ++column) {
+        schedTree->headerItem()->setToolTip(column, status);
+    }
+}
+
+void MainWindow::updateFilesystems()
+{
+    const FilesystemStats &fs = sysInfo->getFilesystemStats();
+    const QVector<MountUsage> &mounts = fs.mounts();
+
+    if (fs.generation() != diskGeneration) {
+        diskGeneration = fs.generation();
+        qDeleteAll(diskRows);
+        diskRows.clear();
+        diskLabels.clear();
+        diskBars.clear();
+
+        for (int i = 0; i < mounts.size(); ++i) {
+            QWidget *rowWidget = new QWidget();
+            QHBoxLayout *row = new QHBoxLayout(rowWidget);
+            row->setContentsMargins(0, 0, 0, 0);
+            QLabel *label = new QLabel();
+            QProgressBar *bar = new QProgressBar();
+            bar->setRange(0, 100);
+            row->addWidget(label);
+            row->addWidget(bar);
+            diskLayout->addWidget(rowWidget);
+            diskRows.append(rowWidget);
+            diskLabels.append(label);
+            diskBars.append(bar);
+        }
+    }
+
+    for (int i = 0; i < mounts.size(); ++i) {
+        const MountUsage &mount = mounts[i];
+        diskLabels[i]->setText(QString("%1: %2% · inodes %3%")
+                               .arg(QString::fromUtf8(mount.mountPoint))
+                               .arg(mount.usedPercent(), 0, 'f', 1)
+                               .arg(mount.inodePercent(), 0, 'f', 1));
+        diskLabels[i]->setToolTip(QString("%1 (%2) — %3 GB livres de %4 GB")
+                                  .arg(QString::fromUtf8(mount.device))
+                                  .arg(QString::fromLatin1(mount.fsType))
+                                  .arg(mount.availBytes / 1e9, 0, 'f', 1)
+                                  .arg(mount.totalBytes / 1e9, 0, 'f', 1));
+        diskBars[i]->setValue((int)mount.usedPercent());
+    }
+}
+
+void MainWindow::onTabChanged(int index)
+{
+    // Coletores que só alimentam uma aba são assinados apenas com ela aberta
+    QWidget *tab = tabs->widget(index);
+    int collectors = 0;
+    if (tab == interruptsTab) collectors = SystemInfo::InterruptsCollector;
+    if (tab == processesTab) collectors = SystemInfo::ProcessesCollector;
+    if (tab == schedTree) collectors = SystemInfo::PerfCollector;
+    if (tab == cgroupTree) collectors = SystemInfo::CgroupsCollector;
+    if (tab == socketTree) collectors = SystemInfo::SocketsCollector;
+    sysInfo->subscribe(this, collectors);
+
+    if (tabs->widget(index) == schedTree) {
+        updatePerfStatus();
+        updateScheduler();
+    }
+    if (tabs->widget(index) == historyTab) {
+        if (!historyLog) {
+            loadHistory(MetricLog::defaultDirectory());
+        } else {
+            refreshHistorySeries();
+            historyView->refresh();
+        }
+    }
+    if (tabs->widget(index) == diffTab) {
+        refreshSnapshotTimes();
+    }
+}
+
+void MainWindow::updateInterrupts()
+{
+    const InterruptStats &stats = sysInfo->getInterruptStats();
+    irqHeatmap->setMatrix(stats.interrupts());
+    softirqHeatmap->setMatrix(stats.softirqs());
+}
+
+void MainWindow::updateProcesses()
+{
+    processModel->update(sysInfo->getProcessStats().processes());
+    updateProcessChurn();
+}
+
+void MainWindow::updateProcessChurn()
+{
+    const ProcessEvents &events = sysInfo->getProcessEvents();
+    const ProcessChurn &churn = events.churn();
+
+    if (events.source() == ProcessEvents::ProcConnector) {
+        QString text = QString("Proc connector: %1 criados/s, %2 exec/s, %3 encerrados/s; "
+                               "%4 não chegaram a ser amostrados; CPU de encerrados: %5%")
+                       .arg(churn.forksPerSec, 0, 'f', 1)
+                       .arg(churn.execsPerSec, 0, 'f', 1)
+                       .arg(churn.exitsPerSec, 0, 'f', 1)
+                       .arg(churn.unseenExits)
+                       .arg(churn.exitedCpuPercent, 0, 'f', 1);
+        if (churn.unattributedExits > 0) {
+            text += QString(" (%1 sem stat final)").arg(churn.unattributedExits);
+        }
+        if (events.overflowCount() > 0) {
+            text += QString("; %1 rajadas perdidas pelo kernel").arg(events.overflowCount());
+        }
+        churnLabel->setText(text);
+    } else {
+        churnLabel->setText(QString("Varredura: %1 novos/s, %2 encerrados/s. Processos mais curtos "
+                                    "que um tick não aparecem (o proc connector exige CAP_NET_ADMIN).")
+                            .arg(churn.forksPerSec, 0, 'f', 1)
+                            .arg(churn.exitsPerSec, 0, 'f', 1));
+    }
+
+    // Encerrados mais recentes, agrupados por nome, com a CPU atribuída
+    QHash<QByteArray, QPair<int, quint64>> byName;
+    for (int i = events.eventCount() - 1, seen = 0; i >= 0 && seen < 500; --i) {
+        const ProcessEvent &event = events.event(i);
+        if (event.type != ProcessEvent::Exit) continue;
+        ++seen;
+        QPair<int, quint64> &entry = byName[QByteArray(event.name)];
+        ++entry.first;
+        entry.second += event.cpuTicks;
+    }
+    QVector<QPair<quint64, QByteArray>> ranked;
+    for (auto it = byName.constBegin(); it != byName.constEnd(); ++it) {
+        ranked.append(qMakePair(it.value().second, it.key()));
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<quint64, QByteArray> &a,
+                                               const QPair<quint64, QByteArray> &b) {
+        return a.first > b.first;
+    });
+
+    const double ticksPerSecond = sysconf(_SC_CLK_TCK);
+    QStringList lines;
+    if (!events.lastError().isEmpty()) lines << events.lastError();
+    for (int i = 0; i < ranked.size() && i < 10; ++i) {
+        const QByteArray &name = ranked[i].second;
+        lines << QString("%1 ×%2: %3 s de CPU")
+                 .arg(name.isEmpty() ? QString("?") : QString::fromUtf8(name))
+                 .arg(byName.value(name).first)
+                 .arg(ranked[i].first / ticksPerSecond, 0, 'f', 2);
+    }
+    churnLabel->setToolTip(lines.join('\n'));
+}
+
+void MainWindow::updateCgroups()
+{
+    const CgroupStats &stats = sysInfo->getCgroupStats();
+    const QVector<CgroupNode> &nodes = stats.nodes();
+    if (!stats.isAvailable()) {
+        if (cgroupTree->topLevelItemCount() == 0) {
+            cgroupTree->addTopLevelItem(new QTreeWidgetItem(QStringList() << "cgroup v2 indisponível"));
+        }
+        return;
+    }
+
+    // Itens recriados só quando cgroups aparecem ou somem; o que estava
+    // expandido continua expandido
+    if (stats.generation() != cgroupGeneration) {
+        cgroupGeneration = stats.generation();
+        QSet<QString> expanded;
+        for (QTreeWidgetItem *item : cgroupItems) {
+            if (item->isExpanded()) expanded.insert(item->data(0, Qt::UserRole).toString());
+        }
+        bool firstBuild = cgroupItems.isEmpty();
+
+        cgroupTree->clear();
+        cgroupItems.clear();
+        for (const CgroupNode &node : nodes) {
+            QStringList columns(QString::fromUtf8(node.name));
+            QTreeWidgetItem *item = node.parent < 0
+                                        ? new QTreeWidgetItem(cgroupTree, columns)
+                                        : new QTreeWidgetItem(cgroupItems[node.parent], columns);
+            QString path = QString::fromUtf8(node.path);
+            item->setData(0, Qt::UserRole, path);
+            item->setToolTip(0, QString::fromUtf8(stats.root()) + "/" + path);
+            cgroupItems.append(item);
+        }
+        for (int i = 0; i < nodes.size(); ++i) {
+            cgroupItems[i]->setExpanded(firstBuild ? nodes[i].depth == 0
+                                                   : expanded.contains(QString::fromUtf8(nodes[i].path)));
+        }
+    }
+
+    for (int i = 0; i < nodes.size() && i < cgroupItems.size(); ++i) {
+        const CgroupNode &node = nodes[i];
+        QTreeWidgetItem *item = cgroupItems[i];
+        item->setText(1, QString::number(node.cpuPercent, 'f', 1));
+        item->setText(2, QString::number(node.memoryBytes / 1048576.0, 'f', 1));
+        item->setText(3, QString::number(node.readBytesPerSec / 1048576.0, 'f', 2));
+        item->setText(4, QString::number(node.writeBytesPerSec / 1048576.0, 'f', 2));
+        item->setDisabled(!node.populated);
+    }
+}
+
+void MainWindow::updateSockets()
+{
+    const SocketStats &stats = sysInfo->getSocketStats();
+    const SocketCounts &counts = stats.counts();
+    const TcpRates &rates = stats.rates();
+
+    // Linhas fixas, criadas na primeira chamada e só reescritas depois
+    int row = 0;
+    auto set = [&](const QString &name, const QString &value) {
+        if (row == socketTree->topLevelItemCount()) {
+            socketTree->addTopLevelItem(new QTreeWidgetItem());
+        }
+        QTreeWidgetItem *item = socketTree->topLevelItem(row++);
+        item->setText(0, name);
+        item->setText(1, value);
+    };
+
+    set("Fonte", stats.source() == SocketStats::Netlink ? QString("netlink sock_diag")
+                                                        : QString("/proc/net/tcp{,6}"));
+    set("Sockets TCP", QString::number(counts.tcpTotal));
+    for (int state = 1; state < SocketCounts::StateCount; ++state) {
+        set(QString("  %1").arg(QString::fromLatin1(SocketStats::stateName(state))),
+            QString::number(counts.tcpStates[state]));
+    }
+    set("Sockets UDP", QString::number(counts.udpTotal));
+    set("Conexões na fila de accept", QString::number(counts.listenQueued));
+    set("Listeners com a fila cheia", stats.source() == SocketStats::Netlink
+                                          ? QString::number(counts.listenersFull) : QString("—"));
+    set("Listen overflows/s", QString::number(rates.listenOverflowsPerSec, 'f', 1));
+    set("Listen drops/s", QString::number(rates.listenDropsPerSec, 'f', 1));
+    set("Segmentos enviados/s", QString::number(rates.outSegsPerSec, 'f', 0));
+    set("Retransmissões/s", QString::number(rates.retransSegsPerSec, 'f', 1));
+    set("Retransmitidos %", QString::number(rates.retransPercent, 'f', 2));
+    set("Aberturas ativas/s", QString::number(rates.activeOpensPerSec, 'f', 1));
+    set("Aberturas passivas/s", QString::number(rates.passiveOpensPerSec, 'f', 1));
+}
+
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    updateSamplingVisibility();
+}
+
+void MainWindow::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateSamplingVisibility();
+}
+
+void MainWindow::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        updateSamplingVisibility();
+    }
+}
+
+void MainWindow::paintEvent(QPaintEvent *event)
+{
+    QMainWindow::paintEvent(event);
+    if (!painted) {
+        painted = true;
+        StartupProfile::mark("primeira pintura");
+        QTimer::singleShot(0, this, &MainWindow::loadHardwareInfo);
+    }
+}
+
+void MainWindow::updateSamplingVisibility()
+{
+    sysInfo->setSubscriberVisible(this, isVisible() && !isMinimized());
+}
+
+void MainWindow::showUsage(double cpu, double mem)
+{
+    cpuUsageLabel->setText(QString("CPU: %1%").arg(cpu, 0, 'f', 1));
+    cpuProgressBar->setValue((int)cpu);
+
+    memUsageLabel->setText(QString("RAM: %1%").arg(mem, 0, 'f', 1));
+    memProgressBar->setValue((int)mem);
+}
+
+void MainWindow::updateDisplay(const Snapshot &snapshot)
+{
+    showUsage(snapshot.cpuUsage(), snapshot.memUsage());
+    StartupProfile::mark("primeira amostra válida");
+
+    updatePercentiles();
+    updateQueries();
+    if (tabs->currentWidget() == schedTree) {
+        updateScheduler();
+    }
+}
+
+void MainWindow::onAnomalyChanged(const QString &metric, bool active, double value, double zScore)
+{
+    activeAnomalies.removeAll(metric);
+    if (active) {
+        activeAnomalies.append(metric);
+        anomalyLabel->setToolTip(QString("%1 = %2% (z = %3)")
+                                 .arg(metric).arg(value, 0, 'f', 1).arg(zScore, 0, 'f', 1));
+    }
+
+    anomalyLabel->setText("Anomalia: " + activeAnomalies.join(", "));
+    anomalyLabel->setVisible(!activeAnomalies.isEmpty());
+}
+
+void MainWindow::updatePercentiles()
+{
+    const MetricHistory &history = sysInfo->getHistory();
+    QVector<int> cores = history.seriesNamed("cpu_core");
+
+    for (int w = 0; w < MetricHistory::WindowCount; ++w) {
+        MetricHistory::Window window = (MetricHistory::Window)w;
+        QuantileSketch rows[3] = {
+            history.quantiles(history.seriesId("cpu"), window),
+            history.quantiles(history.seriesId("mem"), window),
+            history.mergedQuantiles(cores, window)
+        };
 
-    memUsageLabel->setText(QString("RAM: %1%").arg(memUsage, 0, 'f', 1));
-    memProgressBar->setValue((int)memUsage);
+        for (int r = 0; r < 3; ++r) {
+            if (rows[r].count() == 0) continue;
+            percentileLabels[r][w]->setText(QString("%1 / %2 / %3")
+                                            .arg(rows[r].quantile(0.50), 0, 'f', 1)
+                                            .arg(rows[r].quantile(0.95), 0, 'f', 1)
+                                            .arg(rows[r].quantile(0.99), 0, 'f', 1));
+        }
+    }
 }
 
 #include "mainwindow.moc"
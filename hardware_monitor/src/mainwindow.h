@@ -7,7 +7,23 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
+#include <QGridLayout>
+#include <QStringList>
+#include <QTabWidget>
+#include <QScrollArea>
+#include <QTreeWidget>
+#include <QTreeView>
+#include <QListWidget>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QPushButton>
 #include "systeminfo.h"
+#include "heatmapwidget.h"
+#include "processmodel.h"
+#include "historyview.h"
+#include "metricquery.h"
+#include "remotehost.h"
+#include "historyexporter.h"
 
 class MainWindow : public QMainWindow
 {
@@ -17,19 +33,109 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
 private slots:
-    void updateDisplay(double cpuUsage, double memUsage);
+    void updateDisplay(const Snapshot &snapshot);
+    void onAnomalyChanged(const QString &metric, bool active, double value, double zScore);
+    void onTabChanged(int index);
+    void updateInterrupts();
+    void updateFilesystems();
+    void updateProcesses();
+    void updateCgroups();
+    void updateSockets();
+    void openHistory();
+    void onHistorySeriesChanged();
+    void exportHistory();
+    void onExportFinished(bool ok, const QString &error);
+    void addQuery();
+    void removeQuery();
+    void compareSnapshots();
+    void addHost();
+    void removeHost();
 
 private:
     void setupUI();
+    void loadStartupCache();
+    void loadHardwareInfo();
+    void showUsage(double cpu, double mem);
+    QWidget *createInterruptsTab();
+    QWidget *createSchedulerTab();
+    QWidget *createProcessesTab();
+    QWidget *createCgroupsTab();
+    QWidget *createSocketsTab();
+    QWidget *createHistoryTab();
+    void loadHistory(const QString &directory);
+    void refreshHistorySeries();
+    QWidget *createQueriesTab();
+    void updateQueries();
+    QWidget *createDiffTab();
+    void refreshSnapshotTimes();
+    QWidget *createHostsTab();
+    void addRemoteHost(const QString &target);
+    void updateRemoteHost(RemoteHost *host);
+    void saveHosts();
+    void updateScheduler();
+    void updatePerfColumns(QTreeWidgetItem *item, int cpu);
+    void updatePerfStatus();
+    void updateSamplingVisibility();
+    void updateProcessChurn();
+    void updatePercentiles();
 
     SystemInfo *sysInfo;
+    QTabWidget *tabs;
+    QScrollArea *interruptsTab;
+    HeatmapWidget *irqHeatmap;
+    HeatmapWidget *softirqHeatmap;
+    QTreeWidget *schedTree;
+    QWidget *processesTab;
+    QLabel *churnLabel;
+    QTreeView *processView;
+    ProcessModel *processModel;
+    QTreeWidget *cgroupTree;
+    QVector<QTreeWidgetItem *> cgroupItems;   // mesmo índice de CgroupStats::nodes()
+    quint32 cgroupGeneration;
+    QTreeWidget *socketTree;
+    QWidget *historyTab;
+    QLabel *historyPathLabel;
+    QListWidget *historySeriesList;
+    HistoryView *historyView;
+    MetricLog *historyLog;
+    QPushButton *exportButton;
+    QLabel *exportStatus;
+    HistoryExporter *exporter;
+    QLineEdit *queryEdit;
+    QLabel *queryError;
+    QTreeWidget *queryTree;
+    QVector<MetricQuery> queries;
+    QWidget *diffTab;
+    QComboBox *diffFromCombo;
+    QComboBox *diffToCombo;
+    QTreeWidget *diffTree;
+    QLineEdit *hostEdit;
+    QTreeWidget *hostTree;
+    QVector<RemoteHost *> remoteHosts;
+    bool painted;
     QLabel *cpuModelLabel;
     QLabel *ramSizeLabel;
     QLabel *cpuUsageLabel;
     QLabel *memUsageLabel;
     QProgressBar *cpuProgressBar;
     QProgressBar *memProgressBar;
+    QLabel *anomalyLabel;
+    QVBoxLayout *diskLayout;
+    QVector<QWidget *> diskRows;
+    QVector<QLabel *> diskLabels;
+    QVector<QProgressBar *> diskBars;
+    quint32 diskGeneration;
+    QStringList activeAnomalies;
+
+    // [linha: CPU, RAM, núcleos][coluna: janela do MetricHistory]
+    QLabel *percentileLabels[3][MetricHistory::WindowCount];
 };
 
 #endif
@@ -0,0 +1,128 @@
+#include "metrichistory.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+QString seriesKey(const QString &name, const QString &label)
+{
+    return label.isEmpty() ? name : name + '{' + label + '}';
+}
+
+const QuantileSketch &emptySketch()
+{
+    static const QuantileSketch empty;
+    return empty;
+}
+
+}
+
+MetricHistory::MetricHistory(int capacity)
+    : timestamps(capacity), head(0), count(0)
+{
+}
+
+int MetricHistory::addSeries(const QString &name, const QString &label, bool trackQuantiles)
+{
+    QString key = seriesKey(name, label);
+    if (index.contains(key)) {
+        return index.value(key);
+    }
+
+    Series s;
+    s.name = name;
+    s.label = label;
+    s.values = QVector<double>(timestamps.size(), std::numeric_limits<double>::quiet_NaN());
+    if (trackQuantiles) {
+        s.windows.reserve(WindowCount);
+        s.windows.append(WindowedSketch(12, 5 * 1000));       // 1 min em fatias de 5 s
+        s.windows.append(WindowedSketch(12, 5 * 60 * 1000));  // 1 h em fatias de 5 min
+        s.windows.append(WindowedSketch(24, 60 * 60 * 1000)); // 24 h em fatias de 1 h
+    }
+
+    series.append(s);
+    index.insert(key, series.size() - 1);
+    return series.size() - 1;
+}
+
+int MetricHistory::seriesId(const QString &name, const QString &label) const
+{
+    return index.value(seriesKey(name, label), -1);
+}
+
+QVector<int> MetricHistory::seriesNamed(const QString &name) const
+{
+    QVector<int> ids;
+    for (int i = 0; i < series.size(); ++i) {
+        if (series[i].name == name) ids.append(i);
+    }
+    return ids;
+}
+
+void MetricHistory::append(qint64 timestampMs, const QVector<double> &values)
+{
+    int slot;
+    if (count < timestamps.size()) {
+        slot = physical(count);
+        ++count;
+    } else {
+        slot = head;
+        head = (head + 1) % timestamps.size();
+    }
+
+    timestamps[slot] = timestampMs;
+    for (int i = 0; i < series.size(); ++i) {
+        double value = i < values.size() ? values[i] : std::nan("");
+        Series &s = series[i];
+        s.values[slot] = value;
+        for (WindowedSketch &w : s.windows) {
+            w.add(timestampMs, value);
+        }
+    }
+}
+
+int MetricHistory::lowerBound(qint64 timestampMs) const
+{
+    int lo = 0;
+    int hi = count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (timestampAt(mid) < timestampMs) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+MetricHistory::Span MetricHistory::span(int id, int from, int length) const
+{
+    Span result = { { nullptr, nullptr }, { 0, 0 } };
+    if (length <= 0) return result;
+
+    const double *column = series[id].values.constData();
+    int start = physical(from);
+    int first = qMin(length, timestamps.size() - start);
+    result.data[0] = column + start;
+    result.size[0] = first;
+    if (first < length) {
+        result.data[1] = column;
+        result.size[1] = length - first;
+    }
+    return result;
+}
+
+const QuantileSketch &MetricHistory::quantiles(int id, Window window) const
+{
+    if (id < 0 || id >= series.size() || series[id].windows.isEmpty()) {
+        return emptySketch();
+    }
+    return series[id].windows[window].window();
+}
+
+QuantileSketch MetricHistory::mergedQuantiles(const QVector<int> &ids, Window window) const
+{
+    QuantileSketch merged;
+    for (int id : ids) {
+        merged.merge(quantiles(id, window));
+    }
+    return merged;
+}
@@ -0,0 +1,70 @@
+#ifndef METRICHISTORY_H
+#define METRICHISTORY_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include "quantilesketch.h"
+
+// Histórico recente em anéis colunares: uma coluna de timestamps comum e uma
+// coluna de valores por série, todas escritas no mesmo tick. Séries em
+// porcentagem também mantêm sketches de quantis para 1 min / 1 h / 24 h.
+class MetricHistory
+{
+public:
+    enum Window { LastMinute, LastHour, LastDay, WindowCount };
+
+    explicit MetricHistory(int capacity = 3600);
+
+    // label distingue instâncias da mesma métrica (ex.: núcleo "3" de cpu_core)
+    int addSeries(const QString &name, const QString &label = QString(),
+                  bool trackQuantiles = true);
+    int seriesId(const QString &name, const QString &label = QString()) const;
+    QVector<int> seriesNamed(const QString &name) const;
+
+    int seriesCount() const { return series.size(); }
+    QString seriesName(int id) const { return series[id].name; }
+    QString seriesLabel(int id) const { return series[id].label; }
+
+    // values[i] pertence à série i; séries sem valor recebem NaN
+    void append(qint64 timestampMs, const QVector<double> &values);
+
+    int size() const { return count; }
+    int capacity() const { return timestamps.size(); }
+    // i = 0 é a amostra mais antiga ainda no anel
+    qint64 timestampAt(int i) const { return timestamps[physical(i)]; }
+    double valueAt(int id, int i) const { return series[id].values[physical(i)]; }
+    // Índice lógico da primeira amostra com timestamp >= timestampMs
+    int lowerBound(qint64 timestampMs) const;
+
+    // Trecho lógico [from, from + length) de uma coluna: no anel ele ocupa
+    // no máximo dois pedaços contíguos, que os laços percorrem direto
+    struct Span
+    {
+        const double *data[2];
+        int size[2];
+    };
+    Span span(int id, int from, int length) const;
+
+    const QuantileSketch &quantiles(int id, Window window) const;
+    QuantileSketch mergedQuantiles(const QVector<int> &ids, Window window) const;
+
+private:
+    struct Series
+    {
+        QString name;
+        QString label;
+        QVector<double> values;   // double: contadores em bytes passam de 2^24
+        QVector<WindowedSketch> windows;
+    };
+
+    int physical(int i) const { return (head + i) % timestamps.size(); }
+
+    QVector<qint64> timestamps;
+    QVector<Series> series;
+    QHash<QString, int> index;
+    int head;
+    int count;
+};
+
+#endif
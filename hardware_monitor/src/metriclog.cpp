@@ -0,0 +1,447 @@
+#include "metriclog.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QDebug>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int RawRecordSize = 12;      // timestamp + valor
+constexpr int BucketRecordSize = 32;   // first, last, min, max, média, count
+constexpr qint64 RecoveryChunk = 4096;
+
+int recordSize(int level)
+{
+    return level == 0 ? RawRecordSize : BucketRecordSize;
+}
+
+void encode(const LodBucket &bucket, int level, char *out)
+{
+    std::memcpy(out, &bucket.firstMs, 8);
+    if (level == 0) {
+        std::memcpy(out + 8, &bucket.mean, 4);
+        return;
+    }
+    std::memcpy(out + 8, &bucket.lastMs, 8);
+    std::memcpy(out + 16, &bucket.min, 4);
+    std::memcpy(out + 20, &bucket.max, 4);
+    std::memcpy(out + 24, &bucket.mean, 4);
+    std::memcpy(out + 28, &bucket.count, 4);
+}
+
+LodBucket decode(const char *in, int level)
+{
+    LodBucket bucket;
+    std::memcpy(&bucket.firstMs, in, 8);
+    if (level == 0) {
+        std::memcpy(&bucket.mean, in + 8, 4);
+        bucket.lastMs = bucket.firstMs;
+        bucket.min = bucket.max = bucket.mean;
+        bucket.count = 1;
+        return bucket;
+    }
+    std::memcpy(&bucket.lastMs, in + 8, 8);
+    std::memcpy(&bucket.min, in + 16, 4);
+    std::memcpy(&bucket.max, in + 20, 4);
+    std::memcpy(&bucket.mean, in + 24, 4);
+    std::memcpy(&bucket.count, in + 28, 4);
+    return bucket;
+}
+
+void combine(LodBucket &acc, const LodBucket &child, bool first)
+{
+    if (first) {
+        acc = child;
+        return;
+    }
+    double total = double(acc.count) + child.count;
+    acc.mean = float((double(acc.mean) * acc.count + double(child.mean) * child.count) / total);
+    acc.lastMs = child.lastMs;
+    acc.min = qMin(acc.min, child.min);
+    acc.max = qMax(acc.max, child.max);
+    acc.count += child.count;
+}
+
+}
+
+MetricLog::MetricLog(const QString &directory, Mode mode)
+    : dir(directory), mode(mode), rawRetentionMs(qint64(DefaultRawRetentionDays) * 86400000)
+{
+    if (mode == Write && !QDir().mkpath(dir)) {
+        qWarning() << "Histórico em disco desativado: não foi possível criar" << dir;
+        this->mode = ReadOnly;
+    }
+    reload();
+}
+
+MetricLog::~MetricLog()
+{
+    // Buckets parciais ficam só em memória; openWriter os refaz a partir
+    // do nível de baixo na próxima abertura
+    for (Writer &writer : writers) {
+        delete writer.raw;
+    }
+}
+
+QString MetricLog::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/history";
+}
+
+void MetricLog::reload()
+{
+    QFile file(dir + "/series.txt");
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    keys.clear();
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine().trimmed();
+        if (!line.isEmpty()) keys.append(QString::fromUtf8(line));
+    }
+}
+
+QString MetricLog::levelPath(int series, int level) const
+{
+    return QString("%1/%2.%3").arg(dir).arg(series).arg(level);
+}
+
+qint64 MetricLog::levelCount(int series, int level) const
+{
+    return QFileInfo(levelPath(series, level)).size() / recordSize(level);
+}
+
+QVector<LodBucket> MetricLog::readLevel(int series, int level, qint64 index, qint64 count) const
+{
+    QVector<LodBucket> out;
+    QFile file(levelPath(series, level));
+    if (count <= 0 || !file.open(QIODevice::ReadOnly) || !file.seek(index * recordSize(level))) {
+        return out;
+    }
+
+    QByteArray data = file.read(count * recordSize(level));
+    int n = data.size() / recordSize(level);
+    out.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        LodBucket bucket = decode(data.constData() + i * recordSize(level), level);
+        if (bucket.firstMs != 0) out.append(bucket);   // zero: trecho liberado pela retenção
+    }
+    return out;
+}
+
+int MetricLog::addSeries(const QString &key)
+{
+    if (mode != Write) return -1;
+
+    int index = keys.indexOf(key);
+    if (index < 0) {
+        QFile file(dir + "/series.txt");
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) return -1;
+        file.write(key.toUtf8() + '\n');
+        index = keys.size();
+        keys.append(key);
+    }
+
+    if (writers.size() <= index) writers.resize(index + 1);
+    if (!writers[index].raw) openWriter(index);
+    return index;
+}
+
+void MetricLog::openWriter(int series)
+{
+    Writer &writer = writers[series];
+
+    // Registro cortado por uma gravação interrompida é descartado
+    for (int level = 0; QFile::exists(levelPath(series, level)); ++level) {
+        QFile file(levelPath(series, level));
+        qint64 size = file.size();
+        if (size % recordSize(level) != 0) {
+            file.resize(size - size % recordSize(level));
+        }
+    }
+
+    // Refaz nível a nível os buckets que faltam no disco e os parciais em
+    // memória; um log sem pirâmide é reconstruído aqui por inteiro
+    for (int level = 1;; ++level) {
+        qint64 lower = levelCount(series, level - 1);
+        if (lower == 0) break;
+
+        qint64 stored = levelCount(series, level);
+        if (stored * Fanout > lower) {
+            // Buckets gravados antes das amostras chegarem ao disco
+            stored = lower / Fanout;
+            QFile(levelPath(series, level)).resize(stored * BucketRecordSize);
+        }
+        for (qint64 i = stored * Fanout; i < lower; i += RecoveryChunk) {
+            for (const LodBucket &child : readLevel(series, level - 1, i, qMin(RecoveryChunk, lower - i))) {
+                push(writer, series, level, child, false);
+            }
+        }
+    }
+
+    writer.raw = new QFile(levelPath(series, 0));
+    if (!writer.raw->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Não foi possível gravar" << writer.raw->fileName();
+        delete writer.raw;
+        writer.raw = nullptr;
+    }
+}
+
+void MetricLog::push(Writer &writer, int series, int level, const LodBucket &child, bool cascade)
+{
+    if (writer.pending.size() <= level) {
+        writer.pending.resize(level + 1);
+        writer.children.resize(level + 1);
+        writer.levelFiles.resize(level + 1);
+    }
+    if (writer.retainedFrom.size() <= level) {
+        writer.retainedFrom.resize(level + 1);
+        writer.retainedFrom.fill(-1);
+    }
+
+    combine(writer.pending[level], child, writer.children[level] == 0);
+    if (++writer.children[level] < Fanout) return;
+
+    LodBucket done = writer.pending[level];
+    writer.children[level] = 0;
+    writeBucket(writer, series, level, done);
+    if (cascade) {
+        push(writer, series, level + 1, done, true);
+    }
+}
+
+void MetricLog::writeBucket(Writer &writer, int series, int level, const LodBucket &bucket)
+{
+    // Níveis altos recebem um registro a cada Fanout^L amostras: abrir e
+    // fechar sai mais barato que manter um descritor por nível e série. O
+    // caminho é montado uma vez por nível, e não a cada bucket.
+    QByteArray &path = writer.levelFiles[level];
+    if (path.isEmpty()) path = QFile::encodeName(levelPath(series, level));
+
+    char record[BucketRecordSize];
+    encode(bucket, level, record);
+    int fd = ::open(path.constData(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        if (::write(fd, record, BucketRecordSize) != BucketRecordSize) {
+            qWarning() << "Gravação incompleta em" << path;
+        }
+        ::close(fd);
+    }
+}
+
+void MetricLog::append(int series, qint64 timestampMs, float value)
+{
+    if (series < 0 || series >= writers.size() || !writers[series].raw) return;
+    Writer &writer = writers[series];
+
+    LodBucket sample;
+    sample.firstMs = sample.lastMs = timestampMs;
+    sample.min = sample.max = sample.mean = value;
+    sample.count = 1;
+
+    char record[RawRecordSize];
+    encode(sample, 0, record);
+    writer.raw->write(record, RawRecordSize);
+    push(writer, series, 1, sample, true);
+}
+
+void MetricLog::flush()
+{
+    for (Writer &writer : writers) {
+        if (writer.raw) writer.raw->flush();
+    }
+}
+
+void MetricLog::applyRetention(qint64 nowMs)
+{
+    if (mode != Write || rawRetentionMs <= 0) return;
+    static bool unsupported = false;
+    if (unsupported) return;
+
+    for (int series = 0; series < writers.size(); ++series) {
+        Writer &writer = writers[series];
+        if (!writer.raw) continue;
+        writer.raw->flush();
+
+        qint64 retention = rawRetentionMs;
+        for (int level = 0; level < writer.retainedFrom.size(); ++level, retention *= RetentionGrowth) {
+            qint64 &from = writer.retainedFrom[level];
+            if (from < 0) from = firstRetained(series, level);
+
+            // Só o que já está somado num bucket gravado do nível de cima:
+            // openWriter precisa dos filhos do bucket ainda em formação
+            qint64 cutoff = qMin(lowerBound(series, level, nowMs - retention),
+                                 levelCount(series, level + 1) * Fanout);
+            if (cutoff <= from) continue;
+
+            int fd = ::open(writer.levelFiles[level].isEmpty()
+                            ? QFile::encodeName(levelPath(series, level)).constData()
+                            : writer.levelFiles[level].constData(), O_WRONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            int rc = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                               from * recordSize(level), (cutoff - from) * recordSize(level));
+            const int error = rc != 0 ? errno : 0;
+            ::close(fd);
+            if (error == EOPNOTSUPP) {
+                qWarning() << "Retenção do histórico desativada:" << dir
+                           << "não aceita FALLOC_FL_PUNCH_HOLE";
+                unsupported = true;
+                return;
+            }
+            if (error == 0) from = cutoff;
+        }
+    }
+}
+
+qint64 MetricLog::sampleCount(int series) const
+{
+    return levelCount(series, 0);
+}
+
+bool MetricLog::timeRange(int series, qint64 *firstMs, qint64 *lastMs) const
+{
+    qint64 count = sampleCount(series);
+    if (count == 0) return false;
+
+    QVector<LodBucket> last = readLevel(series, 0, count - 1, 1);
+    if (last.isEmpty()) return false;
+    *lastMs = last[0].lastMs;
+
+    // Os níveis altos ficam mais tempo: o início é o do mais antigo retido
+    *firstMs = *lastMs;
+    for (int level = 0; levelCount(series, level) > 0; ++level) {
+        QVector<LodBucket> first = readLevel(series, level, firstRetained(series, level), 1);
+        if (!first.isEmpty()) *firstMs = qMin(*firstMs, first[0].firstMs);
+    }
+    return true;
+}
+
+qint64 MetricLog::lowerBound(QFile &file, int level, qint64 count, qint64 timestampMs) const
+{
+    // Nível 0 pelo timestamp da amostra, os outros pelo fim do bucket.
+    // Trechos liberados lêem 0 e ficam antes de tudo, sem quebrar a ordem.
+    const int offset = level == 0 ? 0 : 8;
+    qint64 lo = 0;
+    qint64 hi = count;
+    while (lo < hi) {
+        qint64 mid = (lo + hi) / 2;
+        qint64 t = 0;
+        if (!file.seek(mid * recordSize(level) + offset)
+            || file.read(reinterpret_cast<char *>(&t), 8) != 8) {
+            break;
+        }
+        if (t < timestampMs) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+qint64 MetricLog::lowerBound(int series, int level, qint64 timestampMs) const
+{
+    QFile file(levelPath(series, level));
+    if (!file.open(QIODevice::ReadOnly)) return 0;
+    return lowerBound(file, level, file.size() / recordSize(level), timestampMs);
+}
+
+qint64 MetricLog::firstRetained(int series, int level) const
+{
+    // Primeiro registro fora do buraco: timestamp 0 não ocorre em dado real
+    return lowerBound(series, level, 1);
+}
+
+qint64 MetricLog::rawIndexAt(int series, qint64 timestampMs, bool roundUp) const
+{
+    qint64 index = lowerBound(series, 0, timestampMs);
+    qint64 retained = firstRetained(series, 0);
+    if (index > retained || retained == 0) return index;
+
+    // Antes das amostras brutas retidas: o índice sai do primeiro nível
+    // que ainda cobre o instante, com a resolução do bucket. Um bucket que
+    // contém o instante entra inteiro: roundUp o inclui no fim do intervalo.
+    qint64 span = Fanout;
+    for (int level = 1; levelCount(series, level) > 0; ++level, span *= Fanout) {
+        qint64 bucket = lowerBound(series, level, timestampMs);
+        qint64 first = firstRetained(series, level);
+        QVector<LodBucket> found = readLevel(series, level, bucket, 1);
+        bool inside = roundUp && !found.isEmpty() && found[0].firstMs < timestampMs;
+        index = qMin(index, (inside ? bucket + 1 : bucket) * span);
+        if (bucket > first || first == 0) break;
+    }
+    return index;
+}
+
+void MetricLog::collect(int series, int level, qint64 span, qint64 begin, qint64 end,
+                        QVector<LodBucket> *out) const
+{
+    if (level == 0) {
+        *out += readLevel(series, 0, begin, end - begin);
+        return;
+    }
+
+    // Buckets completos do nível; a cauda ainda sem bucket vem do nível abaixo
+    qint64 stored = levelCount(series, level);
+    qint64 first = begin / span;
+    qint64 last = qMin((end + span - 1) / span, stored);
+    qint64 covered = begin;
+    if (last > first) {
+        *out += readLevel(series, level, first, last - first);
+        covered = qMax(begin, last * span);
+    }
+    if (covered < end) {
+        collect(series, level - 1, span / Fanout, covered, end, out);
+    }
+}
+
+QVector<LodBucket> MetricLog::query(int series, qint64 fromMs, qint64 toMs, int maxBuckets) const
+{
+    QVector<LodBucket> out;
+    if (series < 0 || series >= keys.size() || maxBuckets <= 0) return out;
+
+    qint64 begin = rawIndexAt(series, fromMs, false);
+    qint64 end = rawIndexAt(series, toMs + 1, true);
+    if (end <= begin) return out;
+
+    // Nível mais fino em que o intervalo cabe em maxBuckets e cujo início
+    // ainda não passou da retenção
+    int level = 0;
+    qint64 span = 1;
+    while ((end - begin) / span > maxBuckets
+           || (begin / span < firstRetained(series, level) && levelCount(series, level + 1) > 0)) {
+        span *= Fanout;
+        ++level;
+    }
+
+    out.reserve(maxBuckets + 2 * Fanout);
+    collect(series, level, span, begin, end, &out);
+    return out;
+}
+
+bool MetricLog::rawRange(int series, qint64 fromMs, qint64 toMs, qint64 *begin, qint64 *end) const
+{
+    if (series < 0 || series >= keys.size()) return false;
+
+    // Exportação é só de amostras brutas: o que a retenção liberou fica de fora
+    *begin = qMax(lowerBound(series, 0, fromMs), firstRetained(series, 0));
+    *end = lowerBound(series, 0, toMs + 1);
+    return *end > *begin;
+}
+
+int MetricLog::readRaw(int series, qint64 index, int count, qint64 *timestamps, float *values) const
+{
+    QFile raw(levelPath(series, 0));
+    if (count <= 0 || !raw.open(QIODevice::ReadOnly) || !raw.seek(index * RawRecordSize)) {
+        return 0;
+    }
+
+    QByteArray data = raw.read(qint64(count) * RawRecordSize);
+    int n = data.size() / RawRecordSize;
+    const char *p = data.constData();
+    for (int i = 0; i < n; ++i, p += RawRecordSize) {
+        std::memcpy(&timestamps[i], p, 8);
+        std::memcpy(&values[i], p + 8, 4);
+    }
+    return n;
+}
@@ -0,0 +1,111 @@
+#ifndef METRICLOG_H
+#define METRICLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QFile>
+#include <QtGlobal>
+
+// Um bucket da pirâmide; no nível 0 é a própria amostra (min = max = mean)
+struct LodBucket
+{
+    qint64 firstMs = 0;
+    qint64 lastMs = 0;
+    float min = 0.0f;
+    float max = 0.0f;
+    float mean = 0.0f;
+    quint32 count = 0;
+};
+
+// Histórico gravado em disco, uma série por arquivo. Ao lado das amostras
+// brutas (nível 0) fica uma pirâmide min/max/média em que cada bucket do
+// nível L resume Fanout buckets do nível L-1. A pirâmide cresce junto com
+// os appends, e uma consulta escolhe o nível mais fino que cabe no número
+// de pixels, lendo só esses buckets em vez do intervalo inteiro.
+//
+// Layout do diretório: series.txt (uma chave por linha; a linha é o índice)
+// e <índice>.<nível> com registros de tamanho fixo em ordem de máquina.
+//
+// Retenção: as amostras brutas ficam rawRetentionMs e cada nível acima
+// fica RetentionGrowth vezes mais que o de baixo, então o espaço total por
+// série se estabiliza. O trecho vencido vira buraco (FALLOC_FL_PUNCH_HOLE):
+// os índices não mudam, e registros zerados são tratados como ausentes.
+class MetricLog
+{
+public:
+    enum Mode { ReadOnly, Write };
+
+    static constexpr int Fanout = 16;
+    static constexpr int DefaultRawRetentionDays = 3;
+    static constexpr int RetentionGrowth = 4;
+
+    explicit MetricLog(const QString &directory, Mode mode = ReadOnly);
+    ~MetricLog();
+
+    MetricLog(const MetricLog &) = delete;
+    MetricLog &operator=(const MetricLog &) = delete;
+
+    static QString defaultDirectory();
+
+    QString directory() const { return dir; }
+    bool isWritable() const { return mode == Write; }
+
+    // Relê series.txt: o gravador pode ter criado séries novas
+    void reload();
+    QStringList seriesKeys() const { return keys; }
+
+    // Escrita: addSeries devolve o índice existente se a chave já existe
+    int addSeries(const QString &key);
+    void append(int series, qint64 timestampMs, float value);
+    void flush();
+
+    void setRawRetentionMs(qint64 ms) { rawRetentionMs = ms; }
+    qint64 rawRetention() const { return rawRetentionMs; }
+    // Libera do disco o que passou da retenção de cada nível; barato se
+    // não há nada vencido, para ser chamado de tempos em tempos
+    void applyRetention(qint64 nowMs);
+
+    qint64 sampleCount(int series) const;
+    bool timeRange(int series, qint64 *firstMs, qint64 *lastMs) const;
+    // Buckets cobrindo [fromMs, toMs], no máximo ~maxBuckets
+    QVector<LodBucket> query(int series, qint64 fromMs, qint64 toMs, int maxBuckets) const;
+
+    // Amostras brutas em lotes, para exportação: rawRange dá os índices de
+    // [fromMs, toMs] e readRaw copia até count registros a partir de index
+    // direto nas colunas do chamador; devolve quantos leu
+    bool rawRange(int series, qint64 fromMs, qint64 toMs, qint64 *begin, qint64 *end) const;
+    int readRaw(int series, qint64 index, int count, qint64 *timestamps, float *values) const;
+
+private:
+    struct Writer
+    {
+        QFile *raw = nullptr;
+        QVector<LodBucket> pending;    // [L]: bucket do nível L em formação
+        QVector<int> children;         // [L]: filhos já somados em pending[L]
+        QVector<QByteArray> levelFiles; // [L]: caminho do nível já codificado
+        QVector<qint64> retainedFrom;  // [L]: primeiro registro não liberado; -1 = não lido
+    };
+
+    QString levelPath(int series, int level) const;
+    qint64 levelCount(int series, int level) const;
+    QVector<LodBucket> readLevel(int series, int level, qint64 index, qint64 count) const;
+    void collect(int series, int level, qint64 span, qint64 begin, qint64 end,
+                 QVector<LodBucket> *out) const;
+    qint64 lowerBound(QFile &file, int level, qint64 count, qint64 timestampMs) const;
+    qint64 lowerBound(int series, int level, qint64 timestampMs) const;
+    qint64 firstRetained(int series, int level) const;
+    qint64 rawIndexAt(int series, qint64 timestampMs, bool roundUp) const;
+
+    void openWriter(int series);
+    void push(Writer &writer, int series, int level, const LodBucket &child, bool cascade);
+    void writeBucket(Writer &writer, int series, int level, const LodBucket &bucket);
+
+    QString dir;
+    Mode mode;
+    QStringList keys;
+    QVector<Writer> writers;
+    qint64 rawRetentionMs;
+};
+
+#endif
@@ -0,0 +1,497 @@
+#include "metricquery.h"
+#include <QHash>
+#include <cmath>
+#include <limits>
+
+// Descida recursiva direto sobre o texto; gera o plano em pós-ordem
+class MetricQueryParser
+{
+public:
+    MetricQueryParser(const QString &text, qint64 maxWindowMs,
+                      QVector<MetricQuery::Instruction> *plan)
+        : text(text), maxWindowMs(maxWindowMs), pos(0), plan(plan) {}
+
+    QString parse(bool *condition)
+    {
+        parseComparison(condition);
+        skipSpaces();
+        if (error.isEmpty() && pos < text.size()) {
+            fail(QString("'%1' inesperado").arg(text.mid(pos, 8)));
+        }
+        return error;
+    }
+
+private:
+    void fail(const QString &message)
+    {
+        if (error.isEmpty()) error = QString("posição %1: %2").arg(pos + 1).arg(message);
+    }
+
+    void skipSpaces()
+    {
+        while (pos < text.size() && text[pos].isSpace()) ++pos;
+    }
+
+    bool accept(const char *token)
+    {
+        skipSpaces();
+        QString t = QString::fromLatin1(token);
+        if (text.mid(pos, t.size()) == t) {
+            pos += t.size();
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char *token)
+    {
+        if (!accept(token)) fail(QString("esperado '%1'").arg(QString::fromLatin1(token)));
+    }
+
+    QString identifier()
+    {
+        skipSpaces();
+        int start = pos;
+        while (pos < text.size() && (text[pos].isLetterOrNumber() || text[pos] == '_')
+               && (pos > start || !text[pos].isDigit())) {
+            ++pos;
+        }
+        return text.mid(start, pos - start);
+    }
+
+    bool number(double *value)
+    {
+        skipSpaces();
+        int start = pos;
+        while (pos < text.size() && (text[pos].isDigit() || text[pos] == '.')) ++pos;
+        // Expoente só se vier dígito depois: "5m" é duração, "1e8" é número
+        if (pos > start && pos + 1 < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+            int exp = pos + 1;
+            if (exp < text.size() && (text[exp] == '+' || text[exp] == '-')) ++exp;
+            if (exp < text.size() && text[exp].isDigit()) {
+                pos = exp;
+                while (pos < text.size() && text[pos].isDigit()) ++pos;
+            }
+        }
+        bool ok = false;
+        *value = text.mid(start, pos - start).toDouble(&ok);
+        if (!ok) pos = start;
+        return ok;
+    }
+
+    void emitOp(MetricQuery::OpCode op)
+    {
+        MetricQuery::Instruction instruction;
+        instruction.op = op;
+        plan->append(instruction);
+    }
+
+    void parseComparison(bool *condition)
+    {
+        parseAdditive();
+        static const struct { const char *token; MetricQuery::OpCode op; } ops[] = {
+            { ">=", MetricQuery::GreaterEqual }, { "<=", MetricQuery::LessEqual },
+            { "==", MetricQuery::Equal }, { "!=", MetricQuery::NotEqual },
+            { ">", MetricQuery::Greater }, { "<", MetricQuery::Less }
+        };
+        for (const auto &entry : ops) {
+            if (accept(entry.token)) {
+                parseAdditive();
+                emitOp(entry.op);
+                *condition = true;
+                return;
+            }
+        }
+    }
+
+    void parseAdditive()
+    {
+        parseTerm();
+        for (;;) {
+            if (accept("+")) { parseTerm(); emitOp(MetricQuery::Add); }
+            else if (accept("-")) { parseTerm(); emitOp(MetricQuery::Subtract); }
+            else return;
+        }
+    }
+
+    void parseTerm()
+    {
+        parseUnary();
+        for (;;) {
+            if (accept("*")) { parseUnary(); emitOp(MetricQuery::Multiply); }
+            else if (accept("/")) { parseUnary(); emitOp(MetricQuery::Divide); }
+            else return;
+        }
+    }
+
+    void parseUnary()
+    {
+        if (accept("-")) {
+            parseUnary();
+            emitOp(MetricQuery::Negate);
+            return;
+        }
+        parsePrimary();
+    }
+
+    QString label()
+    {
+        // Rótulo é texto livre até '}' (pontos de montagem têm '/')
+        if (!accept("{")) return QString();
+        int end = text.indexOf('}', pos);
+        if (end < 0) {
+            fail("'}' não fechado");
+            return QString();
+        }
+        QString result = text.mid(pos, end - pos).trimmed();
+        pos = end + 1;
+        return result;
+    }
+
+    qint64 duration()
+    {
+        double amount = 0.0;
+        if (!number(&amount)) {
+            fail("duração esperada, ex.: 5m");
+            return 0;
+        }
+        QString unit = identifier();
+        qint64 scale = unit == "s" ? 1000 : unit == "m" ? 60000 : unit == "h" ? 3600000
+                     : unit == "d" ? 86400000 : 0;
+        if (scale == 0) fail("unidade deve ser s, m, h ou d");
+        return qint64(amount * scale);
+    }
+
+    void parsePrimary()
+    {
+        if (!error.isEmpty()) return;
+
+        MetricQuery::Instruction instruction;
+        if (number(&instruction.number)) {
+            plan->append(instruction);
+            return;
+        }
+        if (accept("(")) {
+            bool ignored = false;
+            parseComparison(&ignored);
+            expect(")");
+            return;
+        }
+
+        QString name = identifier();
+        if (name.isEmpty()) {
+            fail("esperado número, métrica ou função");
+            return;
+        }
+
+        static const QHash<QString, MetricQuery::Function> functions = {
+            { "avg", MetricQuery::Avg }, { "min", MetricQuery::Min }, { "max", MetricQuery::Max },
+            { "sum", MetricQuery::Sum }, { "count", MetricQuery::Count }, { "last", MetricQuery::Last },
+            { "rate", MetricQuery::Rate }, { "delta", MetricQuery::Delta }
+        };
+        auto function = functions.constFind(name);
+        int afterName = pos;
+        skipSpaces();
+        bool call = function != functions.constEnd()
+                    && (text.mid(pos, 1) == "(" || text.mid(pos, 3) == "by ");
+        pos = afterName;
+
+        if (!call) {
+            instruction.op = MetricQuery::PushInstant;
+            instruction.series = name;
+            instruction.label = label();
+            plan->append(instruction);
+            return;
+        }
+
+        instruction.op = MetricQuery::PushRange;
+        instruction.function = function.value();
+        if (accept("by")) {
+            // O nome do agrupamento é só documentação: cada série tem um rótulo
+            if (identifier().isEmpty()) fail("esperado nome depois de 'by'");
+            instruction.byLabel = true;
+        }
+        expect("(");
+        instruction.series = identifier();
+        if (instruction.series.isEmpty()) fail("esperado nome de métrica");
+        instruction.label = label();
+        expect("[");
+        int windowPos = pos;
+        instruction.windowMs = duration();
+        if (maxWindowMs > 0 && instruction.windowMs > maxWindowMs) {
+            // O anel não guarda a janela inteira: a resposta seria de uma janela menor
+            pos = windowPos;
+            fail(QString("janela maior que o histórico em memória (%1 min)")
+                 .arg(maxWindowMs / 60000));
+        }
+        expect("]");
+        expect(")");
+        plan->append(instruction);
+    }
+
+    const QString &text;
+    qint64 maxWindowMs;
+    int pos;
+    QVector<MetricQuery::Instruction> *plan;
+    QString error;
+};
+
+namespace {
+
+// Acumulado de uma série na janela; só as parcelas que a função usa importam
+struct WindowStats
+{
+    double sum = 0.0;
+    double count = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double last = std::nan("");
+    double increase = 0.0;
+    int first = -1;     // índices lógicos da primeira e da última amostra presentes
+    int newest = -1;
+};
+
+// Cada valor da pilha é um vetor rotulado ou um escalar
+struct StackValue
+{
+    bool scalar = false;
+    QVector<QueryValue> items;
+};
+
+void accumulate(const double *v, int n, WindowStats *stats)
+{
+    double sum = 0.0;
+    double count = 0.0;
+    double low = stats->min;
+    double high = stats->max;
+    for (int i = 0; i < n; ++i) {
+        double x = v[i];
+        bool present = x == x;   // NaN marca tick sem valor
+        sum += present ? x : 0.0;
+        count += present ? 1.0 : 0.0;
+        low = present && x < low ? x : low;
+        high = present && x > high ? x : high;
+    }
+    stats->sum += sum;
+    stats->count += count;
+    stats->min = low;
+    stats->max = high;
+}
+
+// Contador: soma só os incrementos, zerar conta como reinício. base é o
+// índice lógico de v[0], para o chamador achar os timestamps nas pontas.
+void accumulateCounter(const double *v, int n, int base, WindowStats *stats)
+{
+    double increase = stats->increase;
+    double previous = stats->last;
+    int first = stats->first;
+    int newest = stats->newest;
+    for (int i = 0; i < n; ++i) {
+        double x = v[i];
+        if (x != x) continue;
+        if (first >= 0) increase += x >= previous ? x - previous : x;
+        else first = base + i;
+        previous = x;
+        newest = base + i;
+    }
+    stats->increase = increase;
+    stats->last = previous;
+    stats->first = first;
+    stats->newest = newest;
+}
+
+}
+
+MetricQuery::MetricQuery(const QString &text, qint64 maxWindowMs)
+    : source(text.trimmed())
+{
+    MetricQueryParser parser(source, maxWindowMs, &plan);
+    error = parser.parse(&condition);
+    if (!error.isEmpty()) plan.clear();
+    else if (plan.isEmpty()) error = "expressão vazia";
+}
+
+void MetricQuery::resolve(const MetricHistory &history) const
+{
+    if (resolvedHistory == &history && resolvedSeriesCount == history.seriesCount()) return;
+    resolvedHistory = &history;
+    resolvedSeriesCount = history.seriesCount();
+
+    resolvedIds.resize(plan.size());
+    for (int i = 0; i < plan.size(); ++i) {
+        const Instruction &instruction = plan[i];
+        QVector<int> &ids = resolvedIds[i];
+        ids.clear();
+        if (instruction.op != PushInstant && instruction.op != PushRange) continue;
+        for (int id : history.seriesNamed(instruction.series)) {
+            if (instruction.label.isEmpty() || history.seriesLabel(id) == instruction.label) {
+                ids.append(id);
+            }
+        }
+    }
+}
+
+QVector<QueryValue> MetricQuery::evaluate(const MetricHistory &history) const
+{
+    truncated = false;
+    if (!isValid() || history.size() == 0) return QVector<QueryValue>();
+    resolve(history);
+
+    QVector<StackValue> stack;
+    stack.reserve(plan.size());
+
+    const int newest = history.size() - 1;
+    const qint64 nowMs = history.timestampAt(newest);
+
+    for (int i = 0; i < plan.size(); ++i) {
+        const Instruction &instruction = plan[i];
+        const QVector<int> &ids = resolvedIds[i];
+        StackValue result;
+
+        switch (instruction.op) {
+        case PushNumber:
+            result.scalar = true;
+            result.items.append(QueryValue{ QString(), instruction.number });
+            break;
+
+        case PushInstant:
+            for (int id : ids) {
+                double value = history.valueAt(id, newest);
+                if (value == value) result.items.append(QueryValue{ history.seriesLabel(id), value });
+            }
+            // Série sem rótulo (cpu, mem) se comporta como escalar
+            result.scalar = ids.size() == 1 && history.seriesLabel(ids[0]).isEmpty();
+            break;
+
+        case PushRange: {
+            const qint64 windowStart = nowMs - instruction.windowMs + 1;
+            int from = history.lowerBound(windowStart);
+            int length = history.size() - from;
+
+            // Anel cheio com a amostra mais antiga depois do início da janela
+            // (folga de um tick): parte da janela já foi sobrescrita
+            if (history.size() == history.capacity() && history.size() > 1
+                && history.timestampAt(0) - (history.timestampAt(1) - history.timestampAt(0)) > windowStart) {
+                truncated = true;
+                stack.append(result);
+                continue;
+            }
+            WindowStats total;
+            double combined = 0.0;
+            int seriesWithData = 0;
+
+            for (int id : ids) {
+                WindowStats stats;
+                MetricHistory::Span span = history.span(id, from, length);
+                accumulate(span.data[0], span.size[0], &stats);
+                accumulate(span.data[1], span.size[1], &stats);
+                if (stats.count == 0) continue;
+
+                if (instruction.function == Last || instruction.function == Rate
+                    || instruction.function == Delta) {
+                    accumulateCounter(span.data[0], span.size[0], from, &stats);
+                    accumulateCounter(span.data[1], span.size[1], from + span.size[0], &stats);
+                }
+                const double seconds = stats.first >= 0
+                    ? (history.timestampAt(stats.newest) - history.timestampAt(stats.first)) / 1000.0 : 0.0;
+
+                double value = 0.0;
+                switch (instruction.function) {
+                case Avg: value = stats.sum / stats.count; break;
+                case Min: value = stats.min; break;
+                case Max: value = stats.max; break;
+                case Sum: value = stats.sum; break;
+                case Count: value = stats.count; break;
+                case Last: value = stats.last; break;
+                case Rate: value = seconds > 0 ? stats.increase / seconds : 0.0; break;
+                case Delta: value = stats.increase; break;
+                }
+
+                if (instruction.byLabel) {
+                    result.items.append(QueryValue{ history.seriesLabel(id), value });
+                    continue;
+                }
+                total.sum += stats.sum;
+                total.count += stats.count;
+                total.min = qMin(total.min, stats.min);
+                total.max = qMax(total.max, stats.max);
+                combined += value;
+                ++seriesWithData;
+            }
+
+            if (!instruction.byLabel && seriesWithData > 0) {
+                double value = combined;
+                switch (instruction.function) {
+                case Avg: value = total.sum / total.count; break;
+                case Min: value = total.min; break;
+                case Max: value = total.max; break;
+                case Last: value = combined / seriesWithData; break;
+                default: break;
+                }
+                result.scalar = true;
+                result.items.append(QueryValue{ QString(), value });
+            }
+            break;
+        }
+
+        case Negate:
+            result = stack.takeLast();
+            for (QueryValue &item : result.items) item.value = -item.value;
+            break;
+
+        default: {
+            StackValue right = stack.takeLast();
+            StackValue left = stack.takeLast();
+            bool compare = instruction.op >= Greater;
+            result.scalar = left.scalar && right.scalar && !compare;
+
+            // Escalar se aplica a todos; dois vetores casam pelo rótulo
+            QHash<QString, double> rightByLabel;
+            if (!right.scalar) {
+                for (const QueryValue &item : right.items) rightByLabel.insert(item.label, item.value);
+            }
+            const QVector<QueryValue> &driver = left.scalar && !right.scalar ? right.items : left.items;
+            for (const QueryValue &item : driver) {
+                double a;
+                double b;
+                if (left.scalar && !right.scalar) {
+                    if (left.items.isEmpty()) break;
+                    a = left.items[0].value;
+                    b = item.value;
+                } else if (right.scalar) {
+                    if (right.items.isEmpty()) break;
+                    a = item.value;
+                    b = right.items[0].value;
+                } else {
+                    auto match = rightByLabel.constFind(item.label);
+                    if (match == rightByLabel.constEnd()) continue;
+                    a = item.value;
+                    b = match.value();
+                }
+
+                double value = 0.0;
+                bool keep = true;
+                switch (instruction.op) {
+                case Add: value = a + b; break;
+                case Subtract: value = a - b; break;
+                case Multiply: value = a * b; break;
+                case Divide: value = a / b; break;
+                case Greater: keep = a > b; value = a; break;
+                case Less: keep = a < b; value = a; break;
+                case GreaterEqual: keep = a >= b; value = a; break;
+                case LessEqual: keep = a <= b; value = a; break;
+                case Equal: keep = a == b; value = a; break;
+                case NotEqual: keep = a != b; value = a; break;
+                default: break;
+                }
+                if (keep) result.items.append(QueryValue{ item.label, value });
+            }
+            break;
+        }
+        }
+
+        stack.append(result);
+    }
+
+    return stack.isEmpty() ? QVector<QueryValue>() : stack.last().items;
+}
@@ -0,0 +1,84 @@
+#ifndef METRICQUERY_H
+#define METRICQUERY_H
+
+#include <QString>
+#include <QVector>
+#include "metrichistory.h"
+
+struct QueryValue
+{
+    QString label;   // rótulo da série (ex.: núcleo "3"); vazio se agregado
+    double value = 0.0;
+};
+
+// Expressões sobre o MetricHistory, compiladas uma vez num plano de pilha
+// em que cada instrução opera sobre o vetor inteiro de séries:
+//
+//   avg(cpu[5m])                      média de 5 min
+//   max by core(cpu_core[1h])         máximo de 1 h de cada núcleo
+//   rate(disk_read_bytes[1m]) > 1e8   bytes/s somados dos discos, filtrado
+//   cpu_core{0} - cpu                 valor mais recente, por rótulo
+//
+// Funções de janela: avg, min, max, sum, count, last, rate, delta. Sem "by"
+// as séries de mesmo nome são combinadas num escalar (avg/last pela média,
+// sum/count/rate/delta pela soma, min/max pelo extremo); com "by <nome>"
+// sai um valor por rótulo. Comparações filtram: mantêm os elementos da
+// esquerda em que a condição vale, então resultado vazio = alerta inativo.
+class MetricQuery
+{
+public:
+    MetricQuery() = default;
+    // maxWindowMs > 0 recusa janelas maiores que o histórico em memória
+    explicit MetricQuery(const QString &text, qint64 maxWindowMs = 0);
+
+    bool isValid() const { return error.isEmpty() && !plan.isEmpty(); }
+    QString errorString() const { return error; }
+    QString text() const { return source; }
+    // true se a expressão termina numa comparação (condição de alerta)
+    bool isCondition() const { return condition; }
+
+    // Avalia na amostra mais recente do histórico
+    QVector<QueryValue> evaluate(const MetricHistory &history) const;
+    // A última evaluate() pediu uma janela que o anel já sobrescreveu em
+    // parte (ticks mais rápidos que o previsto); essa janela saiu vazia
+    bool wasTruncated() const { return truncated; }
+
+private:
+    enum OpCode {
+        PushNumber,
+        PushInstant,
+        PushRange,
+        Negate,
+        Add, Subtract, Multiply, Divide,
+        Greater, Less, GreaterEqual, LessEqual, Equal, NotEqual
+    };
+    enum Function { Avg, Min, Max, Sum, Count, Last, Rate, Delta };
+
+    struct Instruction
+    {
+        OpCode op = PushNumber;
+        double number = 0.0;
+        Function function = Avg;
+        QString series;
+        QString label;            // seletor {rótulo}; vazio = todos
+        qint64 windowMs = 0;
+        bool byLabel = false;
+    };
+
+    friend class MetricQueryParser;
+
+    void resolve(const MetricHistory &history) const;
+
+    QString source;
+    QString error;
+    QVector<Instruction> plan;
+    bool condition = false;
+
+    // Ids das séries por instrução; refeito quando surgem séries novas
+    mutable QVector<QVector<int>> resolvedIds;
+    mutable const MetricHistory *resolvedHistory = nullptr;
+    mutable int resolvedSeriesCount = -1;
+    mutable bool truncated = false;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#include "perfcounters.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Ordem dos eventos no grupo: o primeiro é o líder, e é também a ordem dos
+// valores devolvidos pelo read() com PERF_FORMAT_GROUP
+struct EventSpec
+{
+    PerfCounters::Event event;
+    quint32 type;
+    quint64 config;
+};
+
+const EventSpec HardwareEvents[] = {
+    { PerfCounters::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PerfCounters::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PerfCounters::CacheMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PerfCounters::ContextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { PerfCounters::Migrations, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+};
+
+const EventSpec SoftwareEvents[] = {
+    { PerfCounters::ContextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { PerfCounters::Migrations, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+};
+
+int perfEventOpen(perf_event_attr *attr, int cpu, int groupFd)
+{
+    return int(syscall(__NR_perf_event_open, attr, -1, cpu, groupFd, PERF_FLAG_FD_CLOEXEC));
+}
+
+}
+
+PerfCounters::PerfCounters()
+    : mode(Closed), error(0)
+{
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+bool PerfCounters::open()
+{
+    if (isOpen()) return true;
+
+    int cpuCount = qMax(1, int(sysconf(_SC_NPROCESSORS_CONF)));
+    groups.resize(cpuCount);
+    rates.fill(CpuPerfRates(), cpuCount);
+    clock.invalidate();
+
+    if (openGroups(Hardware)) {
+        mode = Hardware;
+    } else if (openGroups(Software)) {
+        mode = Software;
+    } else {
+        mode = Unavailable;
+        groups.clear();
+        rates.clear();
+        return false;
+    }
+    return true;
+}
+
+bool PerfCounters::openGroups(Mode wanted)
+{
+    int opened = 0;
+    for (int cpu = 0; cpu < groups.size(); ++cpu) {
+        if (openGroup(groups[cpu], cpu, wanted)) {
+            ++opened;
+        } else if (error != ENODEV) {
+            // ENODEV é só CPU offline; qualquer outra falha vale para todas
+            opened = 0;
+            break;
+        }
+    }
+
+    if (opened == 0) {
+        for (Group &group : groups) {
+            closeGroup(group);
+        }
+    }
+    return opened > 0;
+}
+
+bool PerfCounters::openGroup(Group &group, int cpu, Mode wanted)
+{
+    const EventSpec *specs = wanted == Hardware ? HardwareEvents : SoftwareEvents;
+    const int count = wanted == Hardware ? int(sizeof(HardwareEvents) / sizeof(EventSpec))
+                                         : int(sizeof(SoftwareEvents) / sizeof(EventSpec));
+
+    int leader = -1;
+    for (int i = 0; i < count; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = specs[i].type;
+        attr.config = specs[i].config;
+        if (i == 0) {
+            // O grupo nasce desligado e é ligado de uma vez, já completo
+            attr.disabled = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                               | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        }
+
+        int fd = perfEventOpen(&attr, cpu, leader);
+        if (fd < 0) {
+            error = errno;
+            closeGroup(group);
+            return false;
+        }
+        group.fds[specs[i].event] = fd;
+        if (i == 0) leader = fd;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    group.primed = false;
+    return true;
+}
+
+void PerfCounters::closeGroup(Group &group)
+{
+    for (int &fd : group.fds) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+    group.primed = false;
+}
+
+void PerfCounters::close()
+{
+    for (Group &group : groups) {
+        closeGroup(group);
+    }
+    groups.clear();
+    rates.clear();
+    mode = Closed;
+}
+
+void PerfCounters::sample()
+{
+    if (!isOpen()) return;
+
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+
+    const EventSpec *specs = mode == Hardware ? HardwareEvents : SoftwareEvents;
+    const int count = mode == Hardware ? int(sizeof(HardwareEvents) / sizeof(EventSpec))
+                                       : int(sizeof(SoftwareEvents) / sizeof(EventSpec));
+
+    for (int cpu = 0; cpu < groups.size(); ++cpu) {
+        Group &group = groups[cpu];
+        int leader = group.fds[specs[0].event];
+        if (leader < 0) continue;
+
+        // { nr, time_enabled, time_running, valor[nr] }
+        quint64 buffer[3 + EventCount];
+        ssize_t n = ::read(leader, buffer, sizeof(buffer));
+        if (n < ssize_t((3 + count) * sizeof(quint64)) || buffer[0] != quint64(count)) continue;
+
+        quint64 values[EventCount] = {};
+        for (int i = 0; i < count; ++i) {
+            values[specs[i].event] = buffer[3 + i];
+        }
+        quint64 enabled = buffer[1];
+        quint64 running = buffer[2];
+
+        if (group.primed && seconds > 0.0) {
+            // Com mais grupos que contadores o kernel multiplexa: o grupo só
+            // conta parte do tempo e os deltas são extrapolados
+            quint64 ranFor = running - group.previousRunning;
+            double scale = ranFor > 0 ? double(enabled - group.previousEnabled) / ranFor : 0.0;
+            auto delta = [&](int event) {
+                return double(values[event] - group.previous[event]) * scale;
+            };
+
+            CpuPerfRates &r = rates[cpu];
+            double cycles = delta(Cycles);
+            double instructions = delta(Instructions);
+            double misses = delta(CacheMisses);
+            r.ipc = cycles > 0.0 ? float(instructions / cycles) : 0.0f;
+            r.ghz = float(cycles / seconds / 1e9);
+            r.cacheMissesPerSec = float(misses / seconds);
+            r.missesPerKiloInstr = instructions > 0.0 ? float(misses * 1000.0 / instructions) : 0.0f;
+            r.contextSwitchesPerSec = float(delta(ContextSwitches) / seconds);
+            r.migrationsPerSec = float(delta(Migrations) / seconds);
+        }
+
+        std::memcpy(group.previous, values, sizeof(values));
+        group.previousEnabled = enabled;
+        group.previousRunning = running;
+        group.primed = true;
+    }
+}
+
+CpuPerfRates PerfCounters::total() const
+{
+    // Somas de eventos; IPC e MPKI refeitos a partir dos totais ponderados
+    CpuPerfRates sum;
+    double cycles = 0.0;
+    double instructions = 0.0;
+    for (const CpuPerfRates &r : rates) {
+        cycles += double(r.ghz);
+        instructions += double(r.ghz) * r.ipc;
+        sum.cacheMissesPerSec += r.cacheMissesPerSec;
+        sum.contextSwitchesPerSec += r.contextSwitchesPerSec;
+        sum.migrationsPerSec += r.migrationsPerSec;
+    }
+    if (cycles > 0.0) {
+        sum.ipc = float(instructions / cycles);
+    }
+    if (instructions > 0.0) {
+        sum.missesPerKiloInstr = float(sum.cacheMissesPerSec / (instructions * 1e9) * 1000.0);
+    }
+    if (!rates.isEmpty()) {
+        sum.ghz = float(cycles / rates.size());
+    }
+    return sum;
+}
+
+bool PerfCounters::paranoidLevel(int *level)
+{
+    int fd = ::open("/proc/sys/kernel/perf_event_paranoid", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    char buffer[16] = {};
+    ssize_t n = ::read(fd, buffer, sizeof(buffer) - 1);
+    ::close(fd);
+    return n > 0 && std::sscanf(buffer, "%d", level) == 1;
+}
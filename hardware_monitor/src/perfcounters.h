@@ -0,0 +1,77 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <QVector>
+#include <QElapsedTimer>
+
+// Taxas por CPU de contadores perf_event. IPC baixo com CPU% alto indica
+// carga presa em memória (o núcleo está ocupado, mas esperando cache/RAM);
+// IPC alto é computação de fato. Campos de hardware ficam em zero no modo
+// Software.
+struct CpuPerfRates
+{
+    float ipc = 0.0f;                  // instruções / ciclos
+    float ghz = 0.0f;                  // ciclos contados por segundo de parede
+    float cacheMissesPerSec = 0.0f;
+    float missesPerKiloInstr = 0.0f;   // cache misses por mil instruções
+    float contextSwitchesPerSec = 0.0f;
+    float migrationsPerSec = 0.0f;
+};
+
+// Um grupo perf_event por CPU (pid = -1, cpu = N), lido com um único read()
+// por grupo graças a PERF_FORMAT_GROUP: todos os contadores do grupo são
+// agendados juntos e as razões entre eles são consistentes mesmo com
+// multiplexação. Sem PMU (VMs) ou sem permissão para eventos de hardware o
+// grupo cai para eventos de software (trocas de contexto e migrações).
+class PerfCounters
+{
+public:
+    enum Mode { Closed, Hardware, Software, Unavailable };
+    enum Event { Cycles, Instructions, CacheMisses, ContextSwitches, Migrations, EventCount };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // Abre os grupos; false se nem os eventos de software puderam ser abertos
+    bool open();
+    void close();
+    bool isOpen() const { return mode == Hardware || mode == Software; }
+    Mode currentMode() const { return mode; }
+    // errno da última tentativa que falhou (EACCES, ENOENT...)
+    int lastError() const { return error; }
+
+    // Lê todos os grupos e recalcula as taxas; as primeiras ficam em zero
+    void sample();
+
+    int cpus() const { return rates.size(); }
+    const CpuPerfRates &cpu(int i) const { return rates[i]; }
+    CpuPerfRates total() const;
+
+    // kernel.perf_event_paranoid, para explicar a falha na interface
+    static bool paranoidLevel(int *level);
+
+private:
+    struct Group
+    {
+        int fds[EventCount] = { -1, -1, -1, -1, -1 };
+        quint64 previous[EventCount] = {};
+        quint64 previousEnabled = 0;
+        quint64 previousRunning = 0;
+        bool primed = false;
+    };
+
+    bool openGroups(Mode wanted);
+    bool openGroup(Group &group, int cpu, Mode wanted);
+    void closeGroup(Group &group);
+
+    Mode mode;
+    int error;
+    QVector<Group> groups;
+    QVector<CpuPerfRates> rates;
+    QElapsedTimer clock;
+};
+
+#endif
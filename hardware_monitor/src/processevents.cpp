@@ -0,0 +1,353 @@
+#include "processevents.h"
+#include "procreader.h"
+#include <QDateTime>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+int readSmallFile(const char *path, char *buffer, int size)
+{
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = ::read(fd, buffer, size);
+    ::close(fd);
+    return (int)n;
+}
+
+void copyName(char *name, const char *data, int length)
+{
+    length = qMin(length, 15);
+    std::memcpy(name, data, length);
+    name[length] = '\0';
+}
+
+// fork, exec e exit usam no máximo quatro pids (16 bytes) de event_data
+constexpr size_t MinimumEventLength = offsetof(proc_event, event_data) + 16;
+
+}
+
+ProcessEvents::ProcessEvents()
+    : mode(Closed), netlinkFd(-1), ticksPerSecond(sysconf(_SC_CLK_TCK)), head(0), count(0),
+      overflows(0), primed(false), forks(0), execs(0), exits(0), unseenExits(0),
+      unattributedExits(0), exitedTicks(0)
+{
+}
+
+ProcessEvents::~ProcessEvents()
+{
+    close();
+}
+
+void ProcessEvents::open()
+{
+    if (mode != Closed) return;
+    error.clear();
+    if (ring.isEmpty()) ring.resize(RingCapacity);
+    if (buffer.isEmpty()) buffer.resize(16384);
+
+    netlinkFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (netlinkFd < 0) {
+        fail("socket(NETLINK_CONNECTOR)");
+        return;
+    }
+
+    // Um make -j64 gera rajadas de milhares de eventos entre dois drain()
+    int size = 1 << 20;
+    setsockopt(netlinkFd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+    // O grupo multicast do proc connector exige CAP_NET_ADMIN
+    sockaddr_nl local;
+    std::memset(&local, 0, sizeof(local));
+    local.nl_family = AF_NETLINK;
+    local.nl_groups = CN_IDX_PROC;
+    if (bind(netlinkFd, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0) {
+        fail("bind(CN_IDX_PROC)");
+        return;
+    }
+
+    if (!sendControl(PROC_CN_MCAST_LISTEN)) {
+        fail("PROC_CN_MCAST_LISTEN");
+        return;
+    }
+
+    mode = ProcConnector;
+    primed = false;
+    clock.invalidate();
+}
+
+bool ProcessEvents::sendControl(quint32 op)
+{
+    char request[NLMSG_SPACE(sizeof(cn_msg) + sizeof(quint32))];
+    std::memset(request, 0, sizeof(request));
+    nlmsghdr *header = reinterpret_cast<nlmsghdr *>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(quint32));
+    header->nlmsg_type = NLMSG_DONE;
+    cn_msg *message = static_cast<cn_msg *>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(quint32);
+    std::memcpy(message + 1, &op, sizeof(op));
+    return send(netlinkFd, request, header->nlmsg_len, 0) >= 0;
+}
+
+void ProcessEvents::close()
+{
+    // O kernel só deixa de gerar eventos para o sistema todo quando o
+    // contador de ouvintes volta a zero, e só o IGNORE o decrementa:
+    // fechar o socket sem ele deixa o custo ligado depois da aba fechada
+    if (mode == ProcConnector && netlinkFd >= 0) {
+        sendControl(PROC_CN_MCAST_IGNORE);
+    }
+    if (netlinkFd >= 0) {
+        ::close(netlinkFd);
+        netlinkFd = -1;
+    }
+    mode = Closed;
+    sampled.resize(0);
+    primed = false;
+}
+
+void ProcessEvents::fail(const char *what)
+{
+    error = QString("%1: %2").arg(what, QString::fromLocal8Bit(std::strerror(errno)));
+    if (netlinkFd >= 0) {
+        ::close(netlinkFd);
+        netlinkFd = -1;
+    }
+    mode = Polling;
+}
+
+ProcessEvent &ProcessEvents::append(ProcessEvent::Type type, int pid)
+{
+    int slot;
+    if (count < RingCapacity) {
+        slot = (head + count) % RingCapacity;
+        ++count;
+    } else {
+        // Anel cheio: o mais antigo dá lugar ao novo
+        slot = head;
+        head = (head + 1) % RingCapacity;
+    }
+
+    ProcessEvent &event = ring[slot];
+    event = ProcessEvent();
+    event.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    event.type = type;
+    event.pid = pid;
+    return event;
+}
+
+const ProcessEvents::Sampled *ProcessEvents::findSampled(int pid) const
+{
+    auto it = std::lower_bound(sampled.begin(), sampled.end(), pid,
+                               [](const Sampled &s, int p) { return s.pid < p; });
+    return it != sampled.end() && it->pid == pid ? &*it : nullptr;
+}
+
+void ProcessEvents::exited(int pid, int exitCode)
+{
+    ++exits;
+    ProcessEvent &event = append(ProcessEvent::Exit, pid);
+    event.exitCode = exitCode;
+    const Sampled *seen = findSampled(pid);
+
+    // O evento sai do do_exit(): até o pai colher o zumbi, o stat ainda
+    // tem utime/stime somados de todas as threads
+    char path[32];
+    char stat[1024];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    int n = readSmallFile(path, stat, sizeof(stat));
+    const char *end = stat + qMax(n, 0);
+    const char *open = stat;
+    while (open < end && *open != '(') ++open;
+    const char *close = end;
+    while (close > open && close[-1] != ')') --close;
+
+    if (open >= end || close <= open) {
+        ++unattributedExits;
+        if (seen) {
+            copyName(event.name, seen->name, int(std::strlen(seen->name)));
+        } else {
+            ++unseenExits;
+        }
+        return;
+    }
+    copyName(event.name, open + 1, int(close - open - 2));
+
+    // Campos 14 e 15 (utime, stime) e 22 (starttime), contando a partir do estado (3)
+    quint64 fields[23] = {};
+    const char *p = skipToken(skipSpaces(close, end), end);
+    for (int field = 4; field <= 22 && p < end; ++field) {
+        p = skipSpaces(p, end);
+        if (*p == '-') ++p;
+        p = skipToken(parseUInt(p, end, &fields[field]), end);
+    }
+    event.cpuTicks = fields[14] + fields[15];
+    event.attributed = true;
+
+    // Só o que a varredura ainda não contou: desde a última amostra, ou
+    // tudo se o processo nasceu e morreu entre duas
+    if (seen && seen->startTime == fields[22]) {
+        exitedTicks += event.cpuTicks >= seen->cpuTicks ? event.cpuTicks - seen->cpuTicks : 0;
+    } else {
+        exitedTicks += event.cpuTicks;
+        ++unseenExits;
+    }
+}
+
+void ProcessEvents::drain()
+{
+    if (mode != ProcConnector) return;
+
+    for (;;) {
+        ssize_t n = recv(netlinkFd, buffer.data(), buffer.size(), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == ENOBUFS) {
+            // O kernel descartou eventos (quantos, não diz); o socket continua válido
+            ++overflows;
+            continue;
+        }
+        if (n <= 0) return;
+
+        int remaining = int(n);
+        for (const nlmsghdr *h = reinterpret_cast<const nlmsghdr *>(buffer.constData());
+             NLMSG_OK(h, remaining); h = NLMSG_NEXT(h, remaining)) {
+            if (h->nlmsg_len < NLMSG_LENGTH(sizeof(cn_msg) + MinimumEventLength)) continue;
+            const cn_msg *message = static_cast<const cn_msg *>(NLMSG_DATA(h));
+            if (message->id.idx != CN_IDX_PROC || message->len < MinimumEventLength) continue;
+            const proc_event *event = reinterpret_cast<const proc_event *>(message + 1);
+
+            // Eventos de threads (pid != tgid) não mudam a lista de processos
+            switch (event->what) {
+            case proc_event::PROC_EVENT_FORK: {
+                const auto &fork = event->event_data.fork;
+                if (fork.child_pid != fork.child_tgid) break;
+                ++forks;
+                append(ProcessEvent::Fork, fork.child_tgid).ppid = fork.parent_tgid;
+                break;
+            }
+            case proc_event::PROC_EVENT_EXEC: {
+                const auto &exec = event->event_data.exec;
+                if (exec.process_pid != exec.process_tgid) break;
+                ++execs;
+                ProcessEvent &record = append(ProcessEvent::Exec, exec.process_pid);
+                char path[32];
+                char comm[16];
+                std::snprintf(path, sizeof(path), "/proc/%d/comm", exec.process_pid);
+                int length = readSmallFile(path, comm, sizeof(comm));
+                if (length > 0 && comm[length - 1] == '\n') --length;
+                if (length > 0) copyName(record.name, comm, length);
+                break;
+            }
+            case proc_event::PROC_EVENT_EXIT: {
+                const auto &exit = event->event_data.exit;
+                if (exit.process_pid != exit.process_tgid) break;
+                exited(exit.process_pid, int(exit.exit_code));
+                break;
+            }
+            case proc_event::PROC_EVENT_NONE:
+                // Resposta ao LISTEN: erro aqui é falta de permissão
+                if (event->event_data.ack.err != 0) {
+                    errno = int(event->event_data.ack.err);
+                    fail("PROC_CN_MCAST_LISTEN");
+                    return;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+void ProcessEvents::vanished(const Sampled &process)
+{
+    // Pela varredura não há stat final: fica o último valor amostrado
+    ++exits;
+    ProcessEvent &event = append(ProcessEvent::Exit, process.pid);
+    event.cpuTicks = process.cpuTicks;
+    copyName(event.name, process.name, int(std::strlen(process.name)));
+}
+
+void ProcessEvents::diffPolling(const ProcessStats &stats)
+{
+    // Merge por pid entre a amostra anterior e a nova, as duas ordenadas
+    const StringPool &strings = stats.strings();
+    int j = 0;
+    for (const ProcessInfo &info : stats.processes()) {
+        while (j < sampled.size() && sampled[j].pid < info.pid) {
+            vanished(sampled[j++]);
+        }
+
+        const char *name = strings.data(info.name);
+        const int length = qMin(strings.length(info.name), 15);
+        if (j < sampled.size() && sampled[j].pid == info.pid) {
+            const Sampled &old = sampled[j++];
+            if (old.startTime == info.startTime) {
+                // Mesmo processo com outro comm: houve exec
+                if (int(std::strlen(old.name)) != length || std::memcmp(old.name, name, length) != 0) {
+                    ++execs;
+                    copyName(append(ProcessEvent::Exec, info.pid).name, name, length);
+                }
+                continue;
+            }
+            vanished(old);
+        }
+
+        ++forks;
+        ProcessEvent &event = append(ProcessEvent::Fork, info.pid);
+        event.ppid = info.ppid;
+        copyName(event.name, name, length);
+    }
+    while (j < sampled.size()) {
+        vanished(sampled[j++]);
+    }
+}
+
+void ProcessEvents::collect(const ProcessStats &stats)
+{
+    if (mode == Closed) return;
+
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+
+    if (mode == Polling && primed) {
+        diffPolling(stats);
+    }
+
+    lastChurn = ProcessChurn();
+    if (primed && seconds > 0.0) {
+        lastChurn.forksPerSec = forks / seconds;
+        lastChurn.execsPerSec = execs / seconds;
+        lastChurn.exitsPerSec = exits / seconds;
+        lastChurn.unseenExits = unseenExits;
+        lastChurn.unattributedExits = unattributedExits;
+        lastChurn.exitedCpuPercent = exitedTicks * 100.0 / (seconds * ticksPerSecond);
+    }
+    forks = execs = exits = unseenExits = unattributedExits = 0;
+    exitedTicks = 0;
+
+    // Base para o próximo intervalo; os dois vetores são reaproveitados
+    const StringPool &strings = stats.strings();
+    scratch.resize(0);
+    for (const ProcessInfo &info : stats.processes()) {
+        Sampled s;
+        s.pid = info.pid;
+        s.startTime = info.startTime;
+        s.cpuTicks = info.cpuTicks;
+        copyName(s.name, strings.data(info.name), strings.length(info.name));
+        scratch.append(s);
+    }
+    sampled.swap(scratch);
+    primed = true;
+}
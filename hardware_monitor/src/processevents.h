@@ -0,0 +1,123 @@
+#ifndef PROCESSEVENTS_H
+#define PROCESSEVENTS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include "processstats.h"
+
+struct ProcessEvent
+{
+    enum Type : quint8 { Fork, Exec, Exit };
+
+    qint64 timestampMs = 0;
+    Type type = Fork;
+    bool attributed = false;   // Exit: cpuTicks veio da leitura final do stat
+    int pid = 0;
+    int ppid = 0;              // Fork: pai; nos demais, 0
+    int exitCode = 0;          // Exit: status no formato do wait()
+    quint64 cpuTicks = 0;      // Exit: utime + stime do processo inteiro
+    char name[16] = {};        // comm (TASK_COMM_LEN), vazio se não foi lido
+};
+
+// Rotatividade entre duas chamadas de collect(): o que a varredura
+// periódica do /proc não enxerga sozinha
+struct ProcessChurn
+{
+    double forksPerSec = 0.0;
+    double execsPerSec = 0.0;
+    double exitsPerSec = 0.0;
+    int unseenExits = 0;            // encerrados sem aparecer em nenhuma amostra
+    int unattributedExits = 0;      // stat final não pôde ser lido (já colhido pelo pai)
+    double exitedCpuPercent = 0.0;  // CPU gasta por encerrados desde a última amostra
+};
+
+// Nascimentos e mortes de processos. Com CAP_NET_ADMIN usa o proc
+// connector (NETLINK_CONNECTOR): o kernel avisa cada fork, exec e exit, e
+// no exit o /proc/[pid]/stat é lido na hora para atribuir a CPU de
+// processos que vivem menos que um tick. Sem permissão cai para a
+// comparação entre varreduras, que só vê quem sobreviveu a uma amostra.
+// Os eventos ficam num anel de tamanho fixo; os mais antigos são
+// sobrescritos.
+class ProcessEvents
+{
+public:
+    enum Source { Closed, ProcConnector, Polling };
+
+    static constexpr int RingCapacity = 4096;
+
+    ProcessEvents();
+    ~ProcessEvents();
+
+    ProcessEvents(const ProcessEvents &) = delete;
+    ProcessEvents &operator=(const ProcessEvents &) = delete;
+
+    // Tenta o proc connector e, se falhar, fica no modo Polling
+    void open();
+    void close();
+    bool isOpen() const { return mode != Closed; }
+    Source source() const { return mode; }
+    QString lastError() const { return error; }
+
+    // Descritor para QSocketNotifier; -1 no modo Polling
+    int handle() const { return netlinkFd; }
+    // Lê tudo o que o kernel já enviou, sem bloquear
+    void drain();
+    // Chamado logo após ProcessStats::sample(); drain() deve vir antes da
+    // varredura, para que os exits sejam comparados com a amostra anterior
+    void collect(const ProcessStats &stats);
+
+    const ProcessChurn &churn() const { return lastChurn; }
+    // 0 = mais antigo
+    int eventCount() const { return count; }
+    const ProcessEvent &event(int i) const { return ring[(head + i) % RingCapacity]; }
+    // Vezes em que o buffer do socket encheu e o kernel descartou uma
+    // rajada de eventos (ENOBUFS); o número de eventos perdidos não é conhecido
+    quint64 overflowCount() const { return overflows; }
+
+private:
+    // Último valor visto pela varredura, para separar o que ela já contou
+    struct Sampled
+    {
+        int pid;
+        quint64 startTime;
+        quint64 cpuTicks;
+        char name[16];
+    };
+
+    ProcessEvent &append(ProcessEvent::Type type, int pid);
+    void exited(int pid, int exitCode);
+    void vanished(const Sampled &process);
+    const Sampled *findSampled(int pid) const;
+    void diffPolling(const ProcessStats &stats);
+    bool sendControl(quint32 op);
+    void fail(const char *what);
+
+    Source mode;
+    int netlinkFd;
+    QString error;
+    QByteArray buffer;
+    long ticksPerSecond;
+
+    QVector<ProcessEvent> ring;
+    int head;
+    int count;
+    quint64 overflows;
+
+    QVector<Sampled> sampled;
+    QVector<Sampled> scratch;
+    bool primed;
+
+    // Acumulados desde o último collect()
+    int forks;
+    int execs;
+    int exits;
+    int unseenExits;
+    int unattributedExits;
+    quint64 exitedTicks;
+    ProcessChurn lastChurn;
+    QElapsedTimer clock;
+};
+
+#endif
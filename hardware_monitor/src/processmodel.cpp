@@ -0,0 +1,269 @@
+#include "processmodel.h"
+#include <algorithm>
+#include <cmath>
+
+ProcessModel::ProcessModel(const StringPool *strings, QObject *parent)
+    : QAbstractItemModel(parent), strings(strings), tick(0)
+{
+}
+
+ProcessModel::~ProcessModel()
+{
+    qDeleteAll(nodes);
+}
+
+ProcessModel::Node *ProcessModel::nodeFor(const QModelIndex &index) const
+{
+    return index.isValid() ? static_cast<Node *>(index.internalPointer())
+                           : const_cast<Node *>(&root);
+}
+
+QModelIndex ProcessModel::indexOf(Node *node) const
+{
+    return node == &root ? QModelIndex() : createIndex(node->row, 0, node);
+}
+
+ProcessModel::Node *ProcessModel::effectiveParent(Node *node)
+{
+    // Pai morto ou ausente da varredura: o processo sobe para a raiz
+    Node *parent = node->info.ppid != node->info.pid ? nodes.value(node->info.ppid) : nullptr;
+    return (parent && parent->seen == tick) ? parent : &root;
+}
+
+bool ProcessModel::isInTree(Node *node) const
+{
+    for (; node != &root; node = node->parent) {
+        if (node->row < 0) return false;
+    }
+    return true;
+}
+
+int ProcessModel::depth(Node *node) const
+{
+    int d = 0;
+    for (; node && node != &root; node = node->parent) ++d;
+    return d;
+}
+
+void ProcessModel::detach(Node *node)
+{
+    Node *parent = node->parent;
+    int row = node->row;
+
+    beginRemoveRows(indexOf(parent), row, row);
+    parent->children.remove(row);
+    for (int i = row; i < parent->children.size(); ++i) {
+        parent->children[i]->row = i;
+    }
+    node->parent = nullptr;
+    node->row = -1;
+    endRemoveRows();
+}
+
+void ProcessModel::attach(Node *node, Node *parent)
+{
+    int row = parent->children.size();
+
+    beginInsertRows(indexOf(parent), row, row);
+    parent->children.append(node);
+    node->parent = parent;
+    node->row = row;
+    endInsertRows();
+}
+
+bool ProcessModel::displayDiffers(const ProcessInfo &a, const ProcessInfo &b)
+{
+    return a.state != b.state
+           || a.threads != b.threads
+           || a.fds != b.fds
+           || a.sockets != b.sockets
+           || a.rssKb / 100 != b.rssKb / 100
+           || std::lround(a.cpuPercent * 10) != std::lround(b.cpuPercent * 10)
+           || a.name != b.name
+           || a.user != b.user
+           || a.cmdline != b.cmdline
+           || a.cgroup != b.cgroup;
+}
+
+void ProcessModel::update(const QVector<ProcessInfo> &processes)
+{
+    ++tick;
+
+    QVector<Node *> fresh;
+    QVector<Node *> dead;
+    QVector<Node *> changed;
+
+    for (const ProcessInfo &info : processes) {
+        Node *node = nodes.value(info.pid);
+        if (node && node->info.startTime != info.startTime) {
+            // pid reciclado: o nó antigo morre e um novo entra no lugar
+            dead.append(node);
+            node = nullptr;
+        }
+
+        if (!node) {
+            node = new Node;
+            node->info = info;
+            node->seen = tick;
+            nodes.insert(info.pid, node);
+            fresh.append(node);
+            continue;
+        }
+
+        node->seen = tick;
+        if (displayDiffers(node->info, info)) {
+            changed.append(node);
+        }
+        node->info = info;
+    }
+
+    QVector<Node *> detaching = dead;
+    QVector<Node *> moved;
+    for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+        Node *node = it.value();
+        if (node->seen != tick) {
+            detaching.append(node);
+            dead.append(node);
+        } else if (node->row >= 0 && node->parent != effectiveParent(node)) {
+            detaching.append(node);
+            moved.append(node);
+        }
+    }
+    for (Node *node : dead) {
+        if (nodes.value(node->info.pid) == node) {
+            nodes.remove(node->info.pid);
+        }
+    }
+
+    // Mais profundos primeiro: ao remover um nó, seus ancestrais ainda
+    // estão na árvore e os índices que a view recebe são válidos.
+    QVector<QPair<int, Node *>> byDepth;
+    byDepth.reserve(detaching.size());
+    for (Node *node : detaching) {
+        byDepth.append(qMakePair(depth(node), node));
+    }
+    std::sort(byDepth.begin(), byDepth.end(),
+              [](const QPair<int, Node *> &a, const QPair<int, Node *> &b) { return a.first > b.first; });
+    for (const QPair<int, Node *> &entry : byDepth) {
+        if (entry.second->row >= 0) {
+            detach(entry.second);
+        }
+    }
+    qDeleteAll(dead);
+
+    // Pais antes dos filhos: insere quem já tem o pai na árvore e repete
+    QVector<Node *> pending = fresh + moved;
+    while (!pending.isEmpty()) {
+        QVector<Node *> waiting;
+        for (Node *node : pending) {
+            Node *parent = effectiveParent(node);
+            if (isInTree(parent)) {
+                attach(node, parent);
+            } else {
+                waiting.append(node);
+            }
+        }
+        if (waiting.size() == pending.size()) {
+            // Ciclo de ppid por varredura não atômica: vão para a raiz
+            for (Node *node : waiting) attach(node, &root);
+            break;
+        }
+        pending.swap(waiting);
+    }
+
+    // dataChanged em faixas contíguas de linhas do mesmo pai
+    changed.erase(std::remove_if(changed.begin(), changed.end(),
+                                 [this](Node *node) { return !isInTree(node); }),
+                  changed.end());
+    std::sort(changed.begin(), changed.end(), [](Node *a, Node *b) {
+        return a->parent != b->parent ? a->parent < b->parent : a->row < b->row;
+    });
+    for (int i = 0; i < changed.size();) {
+        int j = i;
+        while (j + 1 < changed.size() && changed[j + 1]->parent == changed[i]->parent
+               && changed[j + 1]->row == changed[j]->row + 1) {
+            ++j;
+        }
+        emit dataChanged(createIndex(changed[i]->row, 0, changed[i]),
+                         createIndex(changed[j]->row, ColumnCount - 1, changed[j]));
+        i = j + 1;
+    }
+}
+
+QModelIndex ProcessModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent)) return QModelIndex();
+    return createIndex(row, column, nodeFor(parent)->children[row]);
+}
+
+QModelIndex ProcessModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid()) return QModelIndex();
+    Node *parent = nodeFor(child)->parent;
+    if (!parent || parent == &root) return QModelIndex();
+    return createIndex(parent->row, 0, parent);
+}
+
+int ProcessModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) return 0;
+    return nodeFor(parent)->children.size();
+}
+
+int ProcessModel::columnCount(const QModelIndex &) const
+{
+    return ColumnCount;
+}
+
+QVariant ProcessModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+    const ProcessInfo &info = nodeFor(index)->info;
+
+    if (role == Qt::TextAlignmentRole) {
+        bool numeric = index.column() == PidColumn || index.column() == CpuColumn
+                       || index.column() == MemoryColumn || index.column() == ThreadsColumn
+                       || index.column() == FdsColumn || index.column() == SocketsColumn;
+        return numeric ? int(Qt::AlignRight | Qt::AlignVCenter) : int(Qt::AlignLeft | Qt::AlignVCenter);
+    }
+    if (role == Qt::ToolTipRole) {
+        return strings->string(info.cmdline);
+    }
+    if (role != Qt::DisplayRole) return QVariant();
+
+    switch (index.column()) {
+    case PidColumn: return info.pid;
+    case NameColumn: return strings->string(info.name);
+    case UserColumn: return strings->string(info.user);
+    case CpuColumn: return QString::number(info.cpuPercent, 'f', 1);
+    case MemoryColumn: return QString::number(info.rssKb / 1024.0, 'f', 1);
+    case ThreadsColumn: return info.threads;
+    // Vazio quando /proc/[pid]/fd não pôde ser lido (outro usuário)
+    case FdsColumn: return info.fds >= 0 ? QVariant(info.fds) : QVariant();
+    case SocketsColumn: return info.sockets >= 0 ? QVariant(info.sockets) : QVariant();
+    case CommandColumn: return strings->string(info.cmdline);
+    case CgroupColumn: return strings->string(info.cgroup);
+    }
+    return QVariant();
+}
+
+QVariant ProcessModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+    case PidColumn: return QString("PID");
+    case NameColumn: return QString("Nome");
+    case UserColumn: return QString("Usuário");
+    case CpuColumn: return QString("CPU %");
+    case MemoryColumn: return QString("Memória (MB)");
+    case ThreadsColumn: return QString("Threads");
+    case FdsColumn: return QString("FDs");
+    case SocketsColumn: return QString("Sockets");
+    case CommandColumn: return QString("Comando");
+    case CgroupColumn: return QString("Cgroup");
+    }
+    return QVariant();
+}
+
+#include "processmodel.moc"
@@ -0,0 +1,72 @@
+#ifndef PROCESSMODEL_H
+#define PROCESSMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
+#include "processstats.h"
+
+// Árvore de processos (pai/filho por PPid) atualizada por diferenças: cada
+// tick gera só beginInsertRows/beginRemoveRows para pids que surgiram,
+// morreram ou mudaram de pai, e dataChanged em faixas contíguas para as
+// linhas alteradas. O modelo nunca é resetado, então o custo acompanha a
+// rotatividade e não o total de processos.
+class ProcessModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        PidColumn,
+        NameColumn,
+        UserColumn,
+        CpuColumn,
+        MemoryColumn,
+        ThreadsColumn,
+        FdsColumn,
+        SocketsColumn,
+        CommandColumn,
+        CgroupColumn,
+        ColumnCount
+    };
+
+    // strings resolve os ids de ProcessInfo e precisa viver mais que o modelo
+    explicit ProcessModel(const StringPool *strings, QObject *parent = nullptr);
+    ~ProcessModel();
+
+    // processes deve vir ordenado por pid (ProcessStats já entrega assim)
+    void update(const QVector<ProcessInfo> &processes);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Node
+    {
+        ProcessInfo info;
+        Node *parent = nullptr;
+        QVector<Node *> children;
+        int row = -1;        // posição em parent->children; -1 = fora da árvore
+        quint32 seen = 0;
+    };
+
+    Node *nodeFor(const QModelIndex &index) const;
+    QModelIndex indexOf(Node *node) const;
+    Node *effectiveParent(Node *node);
+    bool isInTree(Node *node) const;
+    int depth(Node *node) const;
+    void detach(Node *node);
+    void attach(Node *node, Node *parent);
+    static bool displayDiffers(const ProcessInfo &a, const ProcessInfo &b);
+
+    const StringPool *strings;
+    Node root;
+    QHash<int, Node *> nodes;
+    quint32 tick;
+};
+
+#endif
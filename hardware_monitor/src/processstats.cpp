@@ -0,0 +1,331 @@
+#include "processstats.h"
+#include "procreader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Lê um arquivo pequeno do /proc num buffer da pilha
+int readSmallFile(const char *path, char *buffer, int size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = read(fd, buffer, size);
+    close(fd);
+    return (int)n;
+}
+
+}
+
+ProcessStats::ProcessStats()
+    : ticksPerSecond(sysconf(_SC_CLK_TCK)), pageKb(sysconf(_SC_PAGESIZE) / 1024),
+      procFd(-1), fdBudget(DefaultDescriptorBudget), fdCursor(0)
+{
+    // Pequeno de propósito: cada chamada traz umas 300 entradas, então o
+    // orçamento é respeitado com essa granularidade
+    direntBuffer.resize(8192);
+}
+
+ProcessStats::~ProcessStats()
+{
+    if (procFd >= 0) close(procFd);
+    closeDescriptors();
+}
+
+void ProcessStats::setDescriptorBudget(int entries)
+{
+    fdBudget = qMax(0, entries);
+    if (fdBudget == 0) closeDescriptors();
+}
+
+bool ProcessStats::readStat(int pid, ProcessInfo *info)
+{
+    char path[32];
+    char buffer[1024];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+
+    int n = readSmallFile(path, buffer, sizeof(buffer));
+    if (n <= 0) return false;
+    const char *end = buffer + n;
+
+    // "pid (comm) S ppid ..." — comm pode ter espaços e parênteses
+    const char *open = buffer;
+    while (open < end && *open != '(') ++open;
+    const char *close = end;
+    while (close > open && close[-1] != ')') --close;
+    if (open >= end || close <= open) return false;
+
+    info->pid = pid;
+    info->name = pool.intern(open + 1, close - open - 2);
+
+    const char *p = skipSpaces(close, end);
+    info->state = p < end ? *p : '?';
+
+    // Campos numéricos a partir do 4 (ppid); só alguns interessam
+    quint64 fields[22] = {};
+    p = skipToken(p, end);
+    for (int field = 4; field <= 24 && p < end; ++field) {
+        p = skipSpaces(p, end);
+        quint64 value = 0;
+        if (*p == '-') ++p;
+        p = parseUInt(p, end, &value);
+        fields[field - 4] = value;
+        p = skipToken(p, end);
+    }
+
+    info->ppid = (int)fields[4 - 4];
+    info->cpuTicks = fields[14 - 4] + fields[15 - 4];
+    info->threads = (int)fields[20 - 4];
+    info->startTime = fields[22 - 4];
+    info->rssKb = fields[24 - 4] * pageKb;
+    return true;
+}
+
+quint32 ProcessStats::userName(uint uid)
+{
+    auto it = userNames.constFind(uid);
+    if (it != userNames.constEnd()) return it.value();
+
+    char buffer[1024];
+    passwd entry;
+    passwd *result = nullptr;
+    quint32 name = (getpwuid_r(uid, &entry, buffer, sizeof(buffer), &result) == 0 && result)
+                   ? pool.intern(QByteArray(result->pw_name)) : pool.intern(QByteArray::number(uid));
+    userNames.insert(uid, name);
+    return name;
+}
+
+void ProcessStats::readIdentity(ProcessInfo *info)
+{
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%d", info->pid);
+
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        info->user = userName(st.st_uid);
+    }
+
+    char buffer[4096];
+    std::snprintf(path, sizeof(path), "/proc/%d/cmdline", info->pid);
+    int n = readSmallFile(path, buffer, sizeof(buffer));
+    if (n > 0) {
+        // Argumentos vêm separados por NUL
+        for (int i = 0; i < n; ++i) {
+            if (buffer[i] == '\0') buffer[i] = ' ';
+        }
+        while (n > 0 && buffer[n - 1] == ' ') --n;
+        info->cmdline = pool.intern(buffer, n);
+    } else {
+        // Thread do kernel: "[nome]"
+        int length = pool.length(info->name);
+        buffer[0] = '[';
+        std::memcpy(buffer + 1, pool.data(info->name), length);
+        buffer[length + 1] = ']';
+        info->cmdline = pool.intern(buffer, length + 2);
+    }
+
+    // cgroup v2 é a linha "0::/caminho"; hierarquias v1 são ignoradas
+    info->cgroup = 0;
+    std::snprintf(path, sizeof(path), "/proc/%d/cgroup", info->pid);
+    n = readSmallFile(path, buffer, sizeof(buffer));
+    for (const char *p = buffer, *end = buffer + qMax(n, 0); p < end; p = nextLine(p, end)) {
+        if (end - p > 3 && p[0] == '0' && p[1] == ':' && p[2] == ':') {
+            const char *eol = p + 3;
+            while (eol < end && *eol != '\n') ++eol;
+            info->cgroup = pool.intern(p + 3, eol - p - 3);
+            break;
+        }
+    }
+}
+
+void ProcessStats::compactStrings()
+{
+    // Processos mortos deixam strings órfãs no arena; quando elas dominam,
+    // reinterna só o que a tabela atual usa. Os ids mudam, então quem
+    // guarda ProcessInfo precisa ser atualizado com a lista nova no mesmo
+    // tick (o ProcessModel recebe processes() logo após o sample()).
+    StringPool fresh;
+    QVector<quint32> remap(pool.count(), 0);
+    auto move = [&](quint32 &id) {
+        if (id != 0 && remap[id] == 0) {
+            remap[id] = fresh.intern(pool.data(id), pool.length(id));
+        }
+        id = remap[id];
+    };
+
+    for (ProcessInfo &info : current) {
+        move(info.name);
+        move(info.user);
+        move(info.cmdline);
+        move(info.cgroup);
+    }
+    for (auto it = userNames.begin(); it != userNames.end(); ++it) {
+        move(it.value());
+    }
+    pool.swap(fresh);
+}
+
+bool ProcessStats::openDescriptors(const ProcessInfo &info)
+{
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%d/fd", info.pid);
+    fdScan.dirFd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    fdScan.pid = info.pid;
+    fdScan.startTime = info.startTime;
+    fdScan.fds = 0;
+    fdScan.sockets = 0;
+    return fdScan.dirFd >= 0;
+}
+
+void ProcessStats::closeDescriptors()
+{
+    if (fdScan.dirFd >= 0) close(fdScan.dirFd);
+    fdScan.dirFd = -1;
+}
+
+// true quando o diretório acabou; false se o orçamento acabou antes. Os
+// links são lidos num buffer da pilha só para achar "socket:[inode]"
+bool ProcessStats::readDescriptors(int *budget)
+{
+    char target[8];
+    while (*budget > 0) {
+        long n = syscall(SYS_getdents64, fdScan.dirFd, direntBuffer.data(), direntBuffer.size());
+        if (n <= 0) {
+            closeDescriptors();
+            return true;
+        }
+        for (long offset = 0; offset < n;) {
+            const dirent64 *entry = reinterpret_cast<const dirent64 *>(direntBuffer.constData() + offset);
+            offset += entry->d_reclen;
+            if (entry->d_name[0] == '.') continue;
+
+            ++fdScan.fds;
+            --*budget;
+            ssize_t length = readlinkat(fdScan.dirFd, entry->d_name, target, sizeof(target));
+            if (length >= 7 && std::memcmp(target, "socket:", 7) == 0) ++fdScan.sockets;
+        }
+    }
+    return false;
+}
+
+void ProcessStats::scanDescriptors()
+{
+    if (fdBudget <= 0 || current.isEmpty()) return;
+    int budget = fdBudget;
+
+    auto find = [this](int pid) {
+        return std::lower_bound(current.begin(), current.end(), pid,
+                                [](const ProcessInfo &info, int p) { return info.pid < p; });
+    };
+
+    // Termina primeiro o processo que ficou pela metade; se ele morreu ou o
+    // pid foi reciclado, a contagem parcial é descartada
+    int finished = -1;
+    if (fdScan.dirFd >= 0) {
+        auto it = find(fdScan.pid);
+        if (it == current.end() || it->pid != fdScan.pid || it->startTime != fdScan.startTime) {
+            closeDescriptors();
+        } else {
+            if (!readDescriptors(&budget)) return;
+            it->fds = fdScan.fds;
+            it->sockets = fdScan.sockets;
+            finished = fdScan.pid;
+            fdCursor = finished + 1;
+        }
+    }
+
+    // Depois do maior pid volta ao início, passando no máximo uma vez por
+    // processo a cada tick. Abrir o diretório custa uma entrada do
+    // orçamento, para que milhares de processos sem permissão também
+    // fiquem limitados.
+    const int start = int(find(fdCursor) - current.begin());
+    for (int n = 0; n < current.size() && budget > 0; ++n) {
+        ProcessInfo &info = current[(start + n) % current.size()];
+        if (info.pid == finished) continue;
+
+        --budget;
+        if (!openDescriptors(info)) {
+            info.fds = -1;
+            info.sockets = -1;
+        } else if (!readDescriptors(&budget)) {
+            return;
+        } else {
+            info.fds = fdScan.fds;
+            info.sockets = fdScan.sockets;
+        }
+        fdCursor = info.pid + 1;
+    }
+}
+
+void ProcessStats::sample()
+{
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+
+    previous.swap(current);
+    current.clear();
+    current.reserve(previous.size() + 64);
+
+    // /proc fica aberto e é relido do início com getdents64 no mesmo buffer
+    // dos descritores: opendir() alocaria um DIR a cada tick
+    if (procFd < 0) procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (procFd < 0 || lseek(procFd, 0, SEEK_SET) != 0) return;
+
+    for (;;) {
+        long n = syscall(SYS_getdents64, procFd, direntBuffer.data(), direntBuffer.size());
+        if (n <= 0) break;
+        for (long offset = 0; offset < n;) {
+            const dirent64 *entry = reinterpret_cast<const dirent64 *>(direntBuffer.constData() + offset);
+            offset += entry->d_reclen;
+            const char *name = entry->d_name;
+            if (name[0] < '0' || name[0] > '9') continue;
+
+            ProcessInfo info;
+            if (readStat(atoi(name), &info)) {
+                current.append(info);
+            }
+        }
+    }
+
+    std::sort(current.begin(), current.end(),
+              [](const ProcessInfo &a, const ProcessInfo &b) { return a.pid < b.pid; });
+
+    // Merge com o tick anterior: CPU% pelo delta e identidade reaproveitada
+    const double scale = seconds > 0.0 ? 100.0 / (seconds * ticksPerSecond) : 0.0;
+    int j = 0;
+    for (ProcessInfo &info : current) {
+        while (j < previous.size() && previous[j].pid < info.pid) ++j;
+
+        const ProcessInfo *old = (j < previous.size() && previous[j].pid == info.pid
+                                  && previous[j].startTime == info.startTime) ? &previous[j] : nullptr;
+        if (old && old->name == info.name) {
+            info.user = old->user;
+            info.cmdline = old->cmdline;
+            info.cgroup = old->cgroup;
+        } else {
+            readIdentity(&info);
+        }
+
+        if (old && info.cpuTicks >= old->cpuTicks) {
+            info.cpuPercent = float((info.cpuTicks - old->cpuTicks) * scale);
+        }
+        if (old) {
+            info.fds = old->fds;
+            info.sockets = old->sockets;
+        }
+    }
+
+    scanDescriptors();
+
+    // Até quatro strings vivas por processo; muito acima disso é lixo
+    if (pool.count() > 8 * current.size() + 4096) {
+        compactStrings();
+    }
+}
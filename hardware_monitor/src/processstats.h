@@ -0,0 +1,94 @@
+#ifndef PROCESSSTATS_H
+#define PROCESSSTATS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
+#include "stringpool.h"
+
+// Registro de tamanho fixo: textos são ids no StringPool do ProcessStats
+struct ProcessInfo
+{
+    int pid = 0;
+    int ppid = 0;
+    char state = '?';
+    int threads = 0;
+    int fds = -1;            // entradas em /proc/[pid]/fd; -1 sem permissão ou ainda não contado
+    int sockets = -1;        // dessas, quantas apontam para "socket:[...]"
+    quint64 startTime = 0;   // em ticks desde o boot; distingue pids reciclados
+    quint64 cpuTicks = 0;    // utime + stime acumulados
+    float cpuPercent = 0.0f;
+    quint64 rssKb = 0;
+    quint32 name = 0;
+    quint32 user = 0;
+    quint32 cmdline = 0;
+    quint32 cgroup = 0;      // caminho no cgroup v2 (linha "0::")
+};
+
+// Varredura de /proc/[pid]/stat a cada tick. A lista sai ordenada por pid
+// para que consumidores comparem ticks com um merge linear. cmdline e
+// usuário só são lidos quando o processo aparece ou troca de imagem (exec).
+// Nomes, usuários, cmdlines e cgroups se repetem muito entre pids e ticks,
+// por isso ficam internados num único pool.
+//
+// Descritores abertos são contados com getdents64 sobre /proc/[pid]/fd,
+// dentro de um orçamento de entradas por tick. A varredura continua de
+// onde parou no tick seguinte, inclusive no meio de um processo com
+// milhões de fds; enquanto isso vale a última contagem completa.
+class ProcessStats
+{
+public:
+    static constexpr int DefaultDescriptorBudget = 20000;
+
+    ProcessStats();
+    ~ProcessStats();
+
+    ProcessStats(const ProcessStats &) = delete;
+    ProcessStats &operator=(const ProcessStats &) = delete;
+
+    void sample();
+    const QVector<ProcessInfo> &processes() const { return current; }
+    const StringPool &strings() const { return pool; }
+
+    // Entradas de /proc/[pid]/fd lidas por sample(); 0 desliga a contagem
+    void setDescriptorBudget(int entries);
+    int descriptorBudget() const { return fdBudget; }
+
+private:
+    // Diretório fd aberto entre ticks quando o orçamento acaba no meio dele
+    struct DescriptorScan
+    {
+        int dirFd = -1;
+        int pid = 0;
+        quint64 startTime = 0;
+        int fds = 0;
+        int sockets = 0;
+    };
+
+    bool readStat(int pid, ProcessInfo *info);
+    void readIdentity(ProcessInfo *info);
+    quint32 userName(uint uid);
+    void compactStrings();
+    void scanDescriptors();
+    bool openDescriptors(const ProcessInfo &info);
+    bool readDescriptors(int *budget);
+    void closeDescriptors();
+
+    QVector<ProcessInfo> current;
+    QVector<ProcessInfo> previous;
+    StringPool pool;
+    QHash<uint, quint32> userNames;
+    QElapsedTimer clock;
+    long ticksPerSecond;
+    long pageKb;
+    int procFd;
+
+    int fdBudget;
+    int fdCursor;            // próximo pid a varrer
+    DescriptorScan fdScan;
+    QByteArray direntBuffer;
+};
+
+#endif
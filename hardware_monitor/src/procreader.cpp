@@ -0,0 +1,51 @@
+#include "procreader.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+QByteArray procPath(const QByteArray &path)
+{
+    QByteArray root = qgetenv("HWMON_PROC_ROOT");
+    if (root.isEmpty() || !path.startsWith("/proc/") || path.startsWith("/proc/self/")) {
+        return path;
+    }
+    return root + path.mid(5);
+}
+
+ProcReader::ProcReader(const QByteArray &path)
+    : path(procPath(path)), buffer(4096, '\0'), fd(-1), length(0)
+{
+}
+
+ProcReader::~ProcReader()
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool ProcReader::read()
+{
+    length = 0;
+    if (fd < 0) {
+        fd = open(path.constData(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+    }
+
+    for (;;) {
+        if (length == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+
+        // pread a partir do zero faz o kernel regenerar o conteúdo
+        ssize_t n = pread(fd, buffer.data() + length, buffer.size() - length, length);
+        if (n < 0) {
+            close(fd);
+            fd = -1;
+            length = 0;
+            return false;
+        }
+        if (n == 0) break;
+        length += (int)n;
+    }
+    return true;
+}
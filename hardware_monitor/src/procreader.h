@@ -0,0 +1,72 @@
+#ifndef PROCREADER_H
+#define PROCREADER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Leitor de arquivos do /proc com descritor mantido aberto e buffer
+// reaproveitado entre ticks: depois do primeiro uso, reler não aloca nada.
+class ProcReader
+{
+public:
+    explicit ProcReader(const QByteArray &path);
+    ~ProcReader();
+
+    ProcReader(const ProcReader &) = delete;
+    ProcReader &operator=(const ProcReader &) = delete;
+
+    // Relê o arquivo inteiro; false se não existe ou não pôde ser lido
+    bool read();
+
+    const char *begin() const { return buffer.constData(); }
+    const char *end() const { return buffer.constData() + length; }
+    int size() const { return length; }
+    // Descritor aberto (-1 antes da primeira leitura), útil para poll()
+    int handle() const { return fd; }
+
+private:
+    QByteArray path;
+    QByteArray buffer;
+    int fd;
+    int length;
+};
+
+// Troca o prefixo /proc por $HWMON_PROC_ROOT, quando definida, para o
+// hwmon-bench reproduzir um /proc gravado. /proc/self e caminhos fora do
+// /proc ficam como estão.
+QByteArray procPath(const QByteArray &path);
+
+// Varredura numérica sem alocação sobre o buffer bruto
+
+inline const char *skipSpaces(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char *skipToken(const char *p, const char *end)
+{
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n') ++p;
+    return p;
+}
+
+inline const char *nextLine(const char *p, const char *end)
+{
+    while (p < end && *p != '\n') ++p;
+    return p < end ? p + 1 : end;
+}
+
+// Retorna o ponteiro após os dígitos; igual a p se não havia número
+inline const char *parseUInt(const char *p, const char *end, quint64 *value)
+{
+    quint64 v = 0;
+    const char *start = p;
+    while (p < end && (unsigned)(*p - '0') < 10) {
+        v = v * 10 + (unsigned)(*p - '0');
+        ++p;
+    }
+    if (p != start) *value = v;
+    return p;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "quantilesketch.h"
+#include <cmath>
+
+QuantileSketch::QuantileSketch()
+    : total(0)
+{
+    counts.fill(0);
+}
+
+void QuantileSketch::add(double value)
+{
+    if (std::isnan(value)) return;
+
+    int bucket = qBound(0, (int)std::lround(value / Resolution), Buckets - 1);
+    ++counts[bucket];
+    ++total;
+}
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+    for (int i = 0; i < Buckets; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+}
+
+void QuantileSketch::subtract(const QuantileSketch &other)
+{
+    for (int i = 0; i < Buckets; ++i) {
+        counts[i] -= other.counts[i];
+    }
+    total -= other.total;
+}
+
+void QuantileSketch::clear()
+{
+    counts.fill(0);
+    total = 0;
+}
+
+double QuantileSketch::quantile(double q) const
+{
+    if (total == 0) return 0.0;
+
+    quint64 rank = (quint64)std::ceil(qBound(0.0, q, 1.0) * total);
+    if (rank == 0) rank = 1;
+
+    quint64 seen = 0;
+    for (int i = 0; i < Buckets; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return i * Resolution;
+        }
+    }
+    return (Buckets - 1) * Resolution;
+}
+
+WindowedSketch::WindowedSketch(int sliceCount, qint64 sliceMs)
+    : slices(sliceCount), sliceMs(sliceMs), currentSlice(-1)
+{
+}
+
+void WindowedSketch::advanceTo(qint64 slice)
+{
+    if (currentSlice < 0 || slice - currentSlice >= slices.size()) {
+        // Primeira amostra ou intervalo maior que a janela inteira
+        for (QuantileSketch &s : slices) s.clear();
+        total.clear();
+    } else {
+        for (qint64 s = currentSlice + 1; s <= slice; ++s) {
+            QuantileSketch &expired = slices[s % slices.size()];
+            total.subtract(expired);
+            expired.clear();
+        }
+    }
+    currentSlice = slice;
+}
+
+void WindowedSketch::add(qint64 timestampMs, double value)
+{
+    qint64 slice = timestampMs / sliceMs;
+    if (slice > currentSlice) {
+        advanceTo(slice);
+    }
+
+    slices[currentSlice % slices.size()].add(value);
+    total.add(value);
+}
@@ -0,0 +1,52 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+
+// Histograma de buckets fixos (estilo HDR) para métricas em porcentagem:
+// 0..100% em passos de 0,5. Tamanho constante, soma/subtração exatas, então
+// dois sketches se combinam sem perda (ex.: todos os núcleos da CPU).
+class QuantileSketch
+{
+public:
+    static constexpr int Buckets = 201;
+    static constexpr double Resolution = 0.5;
+
+    QuantileSketch();
+
+    void add(double value);
+    void merge(const QuantileSketch &other);
+    void subtract(const QuantileSketch &other);
+    void clear();
+
+    quint64 count() const { return total; }
+    double quantile(double q) const;
+
+private:
+    std::array<quint32, Buckets> counts;
+    quint64 total;
+};
+
+// Janela deslizante de sketches: um anel de fatias de duração fixa mais o
+// total corrente. Inserir é O(1); a cada virada de fatia a mais antiga é
+// subtraída do total e reaproveitada.
+class WindowedSketch
+{
+public:
+    WindowedSketch(int sliceCount = 1, qint64 sliceMs = 1000);
+
+    void add(qint64 timestampMs, double value);
+    const QuantileSketch &window() const { return total; }
+
+private:
+    void advanceTo(qint64 slice);
+
+    QVector<QuantileSketch> slices;
+    QuantileSketch total;
+    qint64 sliceMs;
+    qint64 currentSlice;
+};
+
+#endif
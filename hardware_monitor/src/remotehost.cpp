@@ -0,0 +1,236 @@
+#include "remotehost.h"
+#include <QThread>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+struct RemoteHost::Resolution
+{
+    QByteArray host;
+    QByteArray port;
+    QString error;
+    QVector<Address> addresses;
+};
+
+RemoteHost::RemoteHost(const QString &target, QObject *parent)
+    : QObject(parent), address(target), currentState(Disconnected), fd(-1),
+      readNotifier(nullptr), connectNotifier(nullptr), process(nullptr), nextCandidate(0),
+      receivedBytes(0)
+{
+    reconnectTimer = new QTimer(this);
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, &QTimer::timeout, this, &RemoteHost::open);
+    open();
+}
+
+RemoteHost::~RemoteHost()
+{
+    closeConnection();
+}
+
+double RemoteHost::bytesPerSecond() const
+{
+    qint64 elapsed = connectedClock.isValid() ? connectedClock.elapsed() : 0;
+    return elapsed > 0 ? receivedBytes * 1000.0 / elapsed : 0.0;
+}
+
+void RemoteHost::open()
+{
+    closeConnection();
+    decoder = HostStreamDecoder();
+    receivedBytes = 0;
+    error.clear();
+    currentState = Connecting;
+    emit stateChanged();
+
+    int colon = address.lastIndexOf(':');
+    bool isPort = false;
+    address.mid(colon + 1).toUShort(&isPort);
+    if (colon <= 0 || !isPort || address.contains(' ')) {
+        process = new QProcess(this);
+        connect(process, &QProcess::readyReadStandardOutput, this, &RemoteHost::readProcess);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, &RemoteHost::processFinished);
+        process->start("/bin/sh", QStringList() << "-c" << address);
+        currentState = Connected;
+        connectedClock.start();
+        emit stateChanged();
+        return;
+    }
+
+    auto job = std::make_shared<Resolution>();
+    job->host = address.left(colon).toUtf8();
+    job->port = address.mid(colon + 1).toLatin1();
+    resolving = job;
+
+    // A thread só enxerga o job; sem pai, termina sozinha mesmo que este
+    // RemoteHost seja destruído antes, e a conexão com ele cai junto
+    QThread *resolver = QThread::create([job]() {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_NUMERICSERV | AI_ADDRCONFIG;
+        addrinfo *result = nullptr;
+        int rc = getaddrinfo(job->host.constData(), job->port.constData(), &hints, &result);
+        if (rc != 0) {
+            job->error = QString::fromLocal8Bit(gai_strerror(rc));
+            return;
+        }
+        for (const addrinfo *ai = result; ai; ai = ai->ai_next) {
+            Address candidate;
+            std::memcpy(&candidate.storage, ai->ai_addr, ai->ai_addrlen);
+            candidate.length = ai->ai_addrlen;
+            job->addresses.append(candidate);
+        }
+        freeaddrinfo(result);
+    });
+    connect(resolver, &QThread::finished, this, [this, job]() { resolved(job); });
+    connect(resolver, &QThread::finished, resolver, &QObject::deleteLater);
+    resolver->start();
+}
+
+void RemoteHost::resolved(const std::shared_ptr<Resolution> &job)
+{
+    // Reconexão ou fechamento no meio do caminho: resultado velho
+    if (job != resolving) return;
+    resolving.reset();
+
+    if (job->addresses.isEmpty()) {
+        fail(job->error.isEmpty() ? QString("endereço não encontrado") : job->error);
+        return;
+    }
+    candidates = job->addresses;
+    nextCandidate = 0;
+    candidateError.clear();
+    connectNext();
+}
+
+void RemoteHost::connectNext()
+{
+    // IPv6 e IPv4 do mesmo nome, ou vários A: o primeiro que aceitar
+    while (nextCandidate < candidates.size()) {
+        const Address &candidate = candidates[nextCandidate++];
+        fd = socket(candidate.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int rc = fd < 0 ? -1
+                 : ::connect(fd, reinterpret_cast<const sockaddr *>(&candidate.storage), candidate.length);
+        if (fd >= 0 && (rc == 0 || errno == EINPROGRESS)) {
+            connectNotifier = new QSocketNotifier(fd, QSocketNotifier::Write, this);
+            connect(connectNotifier, &QSocketNotifier::activated, this, &RemoteHost::finishConnect);
+            return;
+        }
+        candidateError = QString::fromLocal8Bit(strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    fail(candidateError.isEmpty() ? QString("endereço não encontrado") : candidateError);
+}
+
+void RemoteHost::finishConnect()
+{
+    connectNotifier->setEnabled(false);
+    connectNotifier->deleteLater();
+    connectNotifier = nullptr;
+
+    int socketError = 0;
+    socklen_t length = sizeof(socketError);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &socketError, &length);
+    if (socketError != 0) {
+        candidateError = QString::fromLocal8Bit(strerror(socketError));
+        close(fd);
+        fd = -1;
+        connectNext();
+        return;
+    }
+    candidates.clear();
+
+    readNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(readNotifier, &QSocketNotifier::activated, this, &RemoteHost::readSocket);
+    currentState = Connected;
+    connectedClock.start();
+    emit stateChanged();
+}
+
+void RemoteHost::readSocket()
+{
+    char buffer[16384];
+    for (;;) {
+        ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            consume(buffer, int(n));
+            if (fd < 0) return;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        fail(n == 0 ? QString("conexão encerrada") : QString::fromLocal8Bit(strerror(errno)));
+        return;
+    }
+}
+
+void RemoteHost::readProcess()
+{
+    QByteArray data = process->readAllStandardOutput();
+    consume(data.constData(), data.size());
+}
+
+void RemoteHost::processFinished()
+{
+    QByteArray stderrText = process->readAllStandardError().trimmed();
+    fail(stderrText.isEmpty() ? QString("comando encerrado") : QString::fromLocal8Bit(stderrText));
+}
+
+void RemoteHost::consume(const char *data, int size)
+{
+    receivedBytes += size;
+    quint64 before = decoder.sampleCount();
+    if (!decoder.feed(data, size)) {
+        fail("fluxo inválido");
+        return;
+    }
+    // Um sinal por leitura, mesmo se vieram vários quadros acumulados
+    if (decoder.sampleCount() != before) {
+        emit updated();
+    }
+}
+
+void RemoteHost::fail(const QString &message)
+{
+    closeConnection();
+    error = message;
+    currentState = Disconnected;
+    emit stateChanged();
+    reconnectTimer->start(ReconnectDelayMs);
+}
+
+void RemoteHost::closeConnection()
+{
+    // Pode ser chamado de dentro de um sinal deles: só deleteLater
+    for (QSocketNotifier *notifier : { readNotifier, connectNotifier }) {
+        if (notifier) {
+            notifier->setEnabled(false);
+            notifier->deleteLater();
+        }
+    }
+    readNotifier = nullptr;
+    connectNotifier = nullptr;
+    resolving.reset();
+    candidates.clear();
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    if (process) {
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+        process = nullptr;
+    }
+}
+
+#include "remotehost.moc"
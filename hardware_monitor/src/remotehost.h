@@ -0,0 +1,83 @@
+#ifndef REMOTEHOST_H
+#define REMOTEHOST_H
+
+#include <QObject>
+#include <QProcess>
+#include <QSocketNotifier>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QVector>
+#include <memory>
+#include <sys/socket.h>
+#include "hoststream.h"
+
+// Uma conexão com um hwmon-agent. "host:porta" conecta por TCP; qualquer
+// outro alvo é um comando de shell cuja saída padrão é o fluxo, por
+// exemplo "ssh servidor hwmon-agent --stdio". Todas as conexões vivem no
+// laço de eventos da interface (QSocketNotifier/QProcess) e se reconectam
+// sozinhas quando caem; só o getaddrinfo roda numa thread avulsa, para um
+// DNS lento não congelar a janela.
+class RemoteHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State { Connecting, Connected, Disconnected };
+
+    explicit RemoteHost(const QString &target, QObject *parent = nullptr);
+    ~RemoteHost();
+
+    QString target() const { return address; }
+    State state() const { return currentState; }
+    QString errorString() const { return error; }
+    const HostStreamDecoder &stream() const { return decoder; }
+    // Média de bytes recebidos por segundo desde que a conexão abriu
+    double bytesPerSecond() const;
+
+signals:
+    void updated();
+    void stateChanged();
+
+private slots:
+    void open();
+    void finishConnect();
+    void readSocket();
+    void readProcess();
+    void processFinished();
+
+private:
+    struct Resolution;
+    struct Address
+    {
+        sockaddr_storage storage;
+        socklen_t length;
+    };
+
+    void resolved(const std::shared_ptr<Resolution> &job);
+    void connectNext();
+    void consume(const char *data, int size);
+    void fail(const QString &message);
+    void closeConnection();
+
+    static constexpr int ReconnectDelayMs = 5000;
+
+    QString address;
+    State currentState;
+    QString error;
+    HostStreamDecoder decoder;
+    int fd;
+    QSocketNotifier *readNotifier;
+    QSocketNotifier *connectNotifier;
+    QProcess *process;
+    // Resolução em andamento; um resultado de outra tentativa é descartado
+    std::shared_ptr<Resolution> resolving;
+    // Endereços do getaddrinfo, tentados em ordem até um conectar
+    QVector<Address> candidates;
+    int nextCandidate;
+    QString candidateError;
+    QTimer *reconnectTimer;
+    QElapsedTimer connectedClock;
+    quint64 receivedBytes;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "schedstats.h"
+
+SchedStats::SchedStats(const QByteArray &path)
+    : file(path), available(true)
+{
+}
+
+bool SchedStats::sample()
+{
+    if (!file.read()) {
+        available = false;
+        return false;
+    }
+
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+    const double perSecond = seconds > 0.0 ? 1.0 / seconds : 0.0;
+
+    const char *p = file.begin();
+    const char *end = file.end();
+    while (p < end) {
+        // "cpu3 0 0 sched_count goidle ttwu ttwu_local run_ns delay_ns slices"
+        if (end - p > 3 && p[0] == 'c' && p[1] == 'p' && p[2] == 'u') {
+            quint64 index = 0;
+            const char *q = parseUInt(p + 3, end, &index);
+            quint64 fields[9] = {};
+            int n = 0;
+            while (n < 9) {
+                q = skipSpaces(q, end);
+                const char *next = parseUInt(q, end, &fields[n]);
+                if (next == q) break;
+                q = next;
+                ++n;
+            }
+
+            if (n == 9 && index < 4096) {
+                int cpu = (int)index;
+                if (cpu >= rates.size()) {
+                    rates.resize(cpu + 1);
+                    previous.resize(cpu + 1);
+                }
+
+                SchedCounters current;
+                current.cpuNs = fields[6];
+                current.waitNs = fields[7];
+                current.slices = fields[8];
+
+                SchedCounters &prev = previous[cpu];
+                if (prev.slices != 0 && current.slices >= prev.slices) {
+                    CpuSchedRates &r = rates[cpu];
+                    r.runPercent = float((current.cpuNs - prev.cpuNs) / 1e7 * perSecond);
+                    r.waitMsPerSec = float((current.waitNs - prev.waitNs) / 1e6 * perSecond);
+                    r.slicesPerSec = float((current.slices - prev.slices) * perSecond);
+                }
+                prev = current;
+            }
+        }
+        p = nextLine(p, end);
+    }
+
+    available = !rates.isEmpty();
+    return available;
+}
+
+CpuSchedRates SchedStats::total() const
+{
+    CpuSchedRates sum;
+    for (const CpuSchedRates &r : rates) {
+        sum.runPercent += r.runPercent;
+        sum.waitMsPerSec += r.waitMsPerSec;
+        sum.slicesPerSec += r.slicesPerSec;
+    }
+    if (!rates.isEmpty()) {
+        sum.runPercent /= rates.size();
+    }
+    return sum;
+}
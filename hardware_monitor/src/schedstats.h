@@ -0,0 +1,47 @@
+#ifndef SCHEDSTATS_H
+#define SCHEDSTATS_H
+
+#include <QVector>
+#include <QElapsedTimer>
+#include "procreader.h"
+
+// Taxas por CPU derivadas de /proc/schedstat (requer CONFIG_SCHEDSTATS).
+// runDelay é o tempo que tarefas prontas passaram esperando na fila: um
+// núcleo a 100% com espera alta tem trabalho represado, sem espera não.
+struct CpuSchedRates
+{
+    float runPercent = 0.0f;     // tempo executando / tempo de parede
+    float waitMsPerSec = 0.0f;   // espera na run-queue por segundo
+    float slicesPerSec = 0.0f;   // timeslices concedidos por segundo
+};
+
+// Contadores acumulados de uma linha "cpuN" do schedstat
+struct SchedCounters
+{
+    quint64 cpuNs = 0;
+    quint64 waitNs = 0;
+    quint64 slices = 0;
+};
+
+class SchedStats
+{
+public:
+    explicit SchedStats(const QByteArray &path = "/proc/schedstat");
+
+    // false se o kernel não expõe schedstat
+    bool sample();
+    bool isAvailable() const { return available; }
+
+    int cpus() const { return rates.size(); }
+    const CpuSchedRates &cpu(int i) const { return rates[i]; }
+    CpuSchedRates total() const;
+
+private:
+    ProcReader file;
+    bool available;
+    QVector<SchedCounters> previous;
+    QVector<CpuSchedRates> rates;
+    QElapsedTimer clock;
+};
+
+#endif
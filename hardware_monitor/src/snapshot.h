@@ -0,0 +1,57 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <QMetaType>
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QVector>
+
+// avg10 de /proc/pressure/{cpu,memory,io}; zero em kernels sem PSI
+struct PressureStats
+{
+    double cpuSome = 0.0;
+    double memorySome = 0.0;
+    double memoryFull = 0.0;
+    double ioSome = 0.0;
+    double ioFull = 0.0;
+};
+
+struct SnapshotData : public QSharedData
+{
+    quint64 version = 0;
+    qint64 timestampMs = 0;
+    int intervalMs = 0;
+    double cpuUsage = 0.0;
+    double memUsage = 0.0;
+    QVector<double> coreUsages;
+    PressureStats pressure;
+};
+
+// Resultado de um tick do SystemInfo, montado uma vez e compartilhado por
+// todos os consumidores. Copiar (inclusive por conexões enfileiradas entre
+// threads) só incrementa um contador atômico; como não há métodos que
+// alterem o conteúdo, o payload nunca é duplicado. version cresce a cada
+// tick: consumidores que recebem o mesmo snapshot duas vezes podem ignorar.
+class Snapshot
+{
+public:
+    Snapshot() : d(new SnapshotData) {}
+    explicit Snapshot(SnapshotData *data) : d(data) {}
+
+    bool isValid() const { return d->version != 0; }
+    quint64 version() const { return d->version; }
+    qint64 timestampMs() const { return d->timestampMs; }
+    int intervalMs() const { return d->intervalMs; }
+    double cpuUsage() const { return d->cpuUsage; }
+    double memUsage() const { return d->memUsage; }
+    const QVector<double> &coreUsages() const { return d->coreUsages; }
+    const PressureStats &pressure() const { return d->pressure; }
+
+private:
+    // Só acesso const: o operator-> const do QSharedDataPointer não destaca
+    QSharedDataPointer<SnapshotData> d;
+};
+
+Q_DECLARE_METATYPE(Snapshot)
+
+#endif
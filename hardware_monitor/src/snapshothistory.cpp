@@ -0,0 +1,373 @@
+#include "snapshothistory.h"
+#include "varint.h"
+#include <QSet>
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+enum DeltaTag : char { Removed = 0, Added = 1, Changed = 2 };
+
+QByteArray readTrimmed(const char *path)
+{
+    char buffer[256];
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return QByteArray();
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    return n > 0 ? QByteArray(buffer, int(n)).trimmed() : QByteArray();
+}
+
+bool byKey(const SnapshotItem &a, const SnapshotItem &b)
+{
+    return a.key < b.key;
+}
+
+bool sameItems(const QVector<SnapshotItem> &a, const QVector<SnapshotItem> &b)
+{
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i].key != b[i].key || a[i].value != b[i].value) return false;
+    }
+    return true;
+}
+
+QVector<SnapshotItem> readInterfaces()
+{
+    QVector<SnapshotItem> items;
+    DIR *dir = opendir("/sys/class/net");
+    if (!dir) return items;
+
+    while (dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+
+        char path[320];
+        SnapshotItem item;
+        item.key = entry->d_name;
+        std::snprintf(path, sizeof(path), "/sys/class/net/%s/operstate", entry->d_name);
+        item.value = readTrimmed(path);
+        std::snprintf(path, sizeof(path), "/sys/class/net/%s/mtu", entry->d_name);
+        item.value += " mtu " + readTrimmed(path);
+        std::snprintf(path, sizeof(path), "/sys/class/net/%s/address", entry->d_name);
+        item.value += " " + readTrimmed(path);
+        items.append(item);
+    }
+    closedir(dir);
+
+    std::sort(items.begin(), items.end(), byKey);
+    return items;
+}
+
+QVector<SnapshotItem> readCgroupLimits(const ProcessStats &processes)
+{
+    static constexpr int MaxCgroups = 512;
+    static const char *const files[] = { "memory.max", "cpu.max", "pids.max" };
+
+    QSet<quint32> seen;
+    QVector<SnapshotItem> items;
+    const StringPool &strings = processes.strings();
+
+    for (const ProcessInfo &info : processes.processes()) {
+        if (info.cgroup == 0 || seen.contains(info.cgroup) || seen.size() >= MaxCgroups) continue;
+        seen.insert(info.cgroup);
+
+        SnapshotItem item;
+        item.key = QByteArray(strings.data(info.cgroup), strings.length(info.cgroup));
+        for (const char *file : files) {
+            QByteArray path = "/sys/fs/cgroup" + item.key + '/' + file;
+            QByteArray value = readTrimmed(path.constData());
+            if (value.isEmpty()) continue;
+            if (!item.value.isEmpty()) item.value += ' ';
+            item.value += QByteArray(file) + '=' + value;
+        }
+        // A raiz e cgroups sem controladores não têm limites para comparar
+        if (!item.value.isEmpty()) items.append(item);
+    }
+
+    std::sort(items.begin(), items.end(), byKey);
+    return items;
+}
+
+QVector<SnapshotDiff::ItemChange> diffItems(const QVector<SnapshotItem> &from,
+                                            const QVector<SnapshotItem> &to)
+{
+    QVector<SnapshotDiff::ItemChange> changes;
+    int i = 0;
+    int j = 0;
+    while (i < from.size() || j < to.size()) {
+        SnapshotDiff::ItemChange change;
+        if (j == to.size() || (i < from.size() && from[i].key < to[j].key)) {
+            change.key = from[i].key;
+            change.before = from[i++].value;
+        } else if (i == from.size() || to[j].key < from[i].key) {
+            change.key = to[j].key;
+            change.after = to[j++].value;
+        } else {
+            if (from[i].value != to[j].value) {
+                change.key = from[i].key;
+                change.before = from[i].value;
+                change.after = to[j].value;
+            }
+            ++i;
+            ++j;
+        }
+        if (!change.key.isEmpty()) changes.append(change);
+    }
+    return changes;
+}
+
+}
+
+SystemSnapshot captureSnapshot(qint64 timestampMs, const ProcessStats &processes,
+                               const FilesystemStats &filesystems)
+{
+    SystemSnapshot snapshot;
+    snapshot.timestampMs = timestampMs;
+
+    // ProcessStats já entrega a lista ordenada por pid
+    const StringPool &strings = processes.strings();
+    snapshot.processes.reserve(processes.processes().size());
+    for (const ProcessInfo &info : processes.processes()) {
+        SnapshotProcess process;
+        process.pid = info.pid;
+        process.startTime = info.startTime;
+        process.rssKb = info.rssKb;
+        process.cpuTicks = info.cpuTicks;
+        process.name = QByteArray(strings.data(info.name), strings.length(info.name));
+        snapshot.processes.append(process);
+    }
+
+    for (const MountUsage &mount : filesystems.mounts()) {
+        SnapshotItem item;
+        item.key = mount.mountPoint;
+        item.value = mount.device + ' ' + mount.fsType;
+        snapshot.mounts.append(item);
+    }
+    std::sort(snapshot.mounts.begin(), snapshot.mounts.end(), byKey);
+
+    snapshot.interfaces = readInterfaces();
+    snapshot.cgroupLimits = readCgroupLimits(processes);
+    return snapshot;
+}
+
+SnapshotDiff diffSnapshots(const SystemSnapshot &from, const SystemSnapshot &to)
+{
+    SnapshotDiff diff;
+    const double seconds = (to.timestampMs - from.timestampMs) / 1000.0;
+    const double ticksPerSecond = sysconf(_SC_CLK_TCK);
+
+    // Merge pelas duas listas ordenadas por pid; pid reciclado conta como
+    // um processo que saiu e outro que entrou
+    int i = 0;
+    int j = 0;
+    const QVector<SnapshotProcess> &a = from.processes;
+    const QVector<SnapshotProcess> &b = to.processes;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() || (i < a.size() && a[i].pid < b[j].pid)) {
+            diff.disappeared.append(a[i++]);
+        } else if (i == a.size() || b[j].pid < a[i].pid) {
+            diff.appeared.append(b[j++]);
+        } else if (a[i].startTime != b[j].startTime) {
+            diff.disappeared.append(a[i++]);
+            diff.appeared.append(b[j++]);
+        } else {
+            SnapshotDiff::Growth growth;
+            growth.before = a[i++];
+            growth.after = b[j++];
+            if (seconds > 0 && growth.after.cpuTicks > growth.before.cpuTicks) {
+                growth.cpuPercent = 100.0 * (growth.after.cpuTicks - growth.before.cpuTicks)
+                                    / ticksPerSecond / seconds;
+                diff.cpuUsage.append(growth);
+            }
+            if (growth.after.rssKb > growth.before.rssKb) {
+                diff.rssGrowth.append(growth);
+            }
+        }
+    }
+
+    auto rssDelta = [](const SnapshotDiff::Growth &g) { return g.after.rssKb - g.before.rssKb; };
+    std::sort(diff.rssGrowth.begin(), diff.rssGrowth.end(),
+              [&](const SnapshotDiff::Growth &x, const SnapshotDiff::Growth &y) { return rssDelta(x) > rssDelta(y); });
+    std::sort(diff.cpuUsage.begin(), diff.cpuUsage.end(),
+              [](const SnapshotDiff::Growth &x, const SnapshotDiff::Growth &y) { return x.cpuPercent > y.cpuPercent; });
+    if (diff.rssGrowth.size() > SnapshotDiff::MaxGrowthRows) diff.rssGrowth.resize(SnapshotDiff::MaxGrowthRows);
+    if (diff.cpuUsage.size() > SnapshotDiff::MaxGrowthRows) diff.cpuUsage.resize(SnapshotDiff::MaxGrowthRows);
+
+    diff.mounts = diffItems(from.mounts, to.mounts);
+    diff.interfaces = diffItems(from.interfaces, to.interfaces);
+    diff.cgroupLimits = diffItems(from.cgroupLimits, to.cgroupLimits);
+    return diff;
+}
+
+SnapshotHistory::SnapshotHistory(int capacity)
+    : capacity(capacity), sinceKeyframe(0)
+{
+}
+
+QByteArray SnapshotHistory::encode(const QVector<SnapshotProcess> &previous,
+                                   const QVector<SnapshotProcess> &current)
+{
+    // Processos que não mudaram não geram nada; o pid vai como diferença
+    // para o último pid escrito, quase sempre um byte
+    QByteArray out;
+    int lastPid = 0;
+    auto putPid = [&](int pid) {
+        putVarint(out, quint64(pid - lastPid));
+        lastPid = pid;
+    };
+    auto putAdded = [&](const SnapshotProcess &p) {
+        out.append(char(Added));
+        putPid(p.pid);
+        putVarint(out, p.startTime);
+        putVarint(out, p.rssKb);
+        putVarint(out, p.cpuTicks);
+        putVarint(out, quint64(p.name.size()));
+        out.append(p.name);
+    };
+
+    int i = 0;
+    int j = 0;
+    while (i < previous.size() || j < current.size()) {
+        if (j == current.size() || (i < previous.size() && previous[i].pid < current[j].pid)) {
+            out.append(char(Removed));
+            putPid(previous[i++].pid);
+        } else if (i == previous.size() || current[j].pid < previous[i].pid) {
+            putAdded(current[j++]);
+        } else if (previous[i].startTime != current[j].startTime || previous[i].name != current[j].name) {
+            out.append(char(Removed));
+            putPid(previous[i++].pid);
+            putAdded(current[j++]);
+        } else {
+            const SnapshotProcess &before = previous[i++];
+            const SnapshotProcess &after = current[j++];
+            if (before.rssKb != after.rssKb || before.cpuTicks != after.cpuTicks) {
+                out.append(char(Changed));
+                putPid(after.pid);
+                putVarint(out, zigzag(qint64(after.rssKb - before.rssKb)));
+                putVarint(out, zigzag(qint64(after.cpuTicks - before.cpuTicks)));
+            }
+        }
+    }
+    return out;
+}
+
+QVector<SnapshotProcess> SnapshotHistory::decode(const QVector<SnapshotProcess> &previous,
+                                                 const QByteArray &delta)
+{
+    QVector<SnapshotProcess> out;
+    out.reserve(previous.size() + 16);
+
+    const char *p = delta.constData();
+    const char *end = p + delta.size();
+    int i = 0;
+    int pid = 0;
+    while (p < end) {
+        char tag = *p++;
+        pid += int(getVarint(p, end));
+        while (i < previous.size() && previous[i].pid < pid) {
+            out.append(previous[i++]);
+        }
+
+        if (tag == Removed) {
+            if (i < previous.size() && previous[i].pid == pid) ++i;
+        } else if (tag == Added) {
+            SnapshotProcess process;
+            process.pid = pid;
+            process.startTime = getVarint(p, end);
+            process.rssKb = getVarint(p, end);
+            process.cpuTicks = getVarint(p, end);
+            int length = int(qMin<quint64>(getVarint(p, end), quint64(end - p)));
+            process.name = QByteArray(p, length);
+            p += length;
+            out.append(process);
+        } else if (i < previous.size() && previous[i].pid == pid) {
+            SnapshotProcess process = previous[i++];
+            process.rssKb += unzigzag(getVarint(p, end));
+            process.cpuTicks += unzigzag(getVarint(p, end));
+            out.append(process);
+        }
+    }
+    while (i < previous.size()) {
+        out.append(previous[i++]);
+    }
+    return out;
+}
+
+void SnapshotHistory::append(const SystemSnapshot &snapshot)
+{
+    Entry entry;
+    entry.timestampMs = snapshot.timestampMs;
+    entry.keyframe = entries.isEmpty() || sinceKeyframe + 1 >= KeyframeInterval;
+    entry.processes = encode(entry.keyframe ? QVector<SnapshotProcess>() : last, snapshot.processes);
+    sinceKeyframe = entry.keyframe ? 0 : sinceKeyframe + 1;
+
+    // Lista igual à anterior reaproveita os mesmos dados compartilhados
+    const Entry *previous = entries.isEmpty() ? nullptr : &entries.last();
+    entry.mounts = previous && sameItems(previous->mounts, snapshot.mounts)
+                   ? previous->mounts : snapshot.mounts;
+    entry.interfaces = previous && sameItems(previous->interfaces, snapshot.interfaces)
+                       ? previous->interfaces : snapshot.interfaces;
+    entry.cgroupLimits = previous && sameItems(previous->cgroupLimits, snapshot.cgroupLimits)
+                         ? previous->cgroupLimits : snapshot.cgroupLimits;
+
+    last = snapshot.processes;
+    entries.append(entry);
+
+    if (entries.size() > capacity) {
+        // O novo primeiro precisa virar quadro completo antes do descarte
+        if (!entries[1].keyframe) {
+            entries[1].processes = encode(QVector<SnapshotProcess>(), snapshotAt(1).processes);
+            entries[1].keyframe = true;
+        }
+        entries.removeFirst();
+    }
+}
+
+int SnapshotHistory::indexNear(qint64 timestampMs) const
+{
+    if (entries.isEmpty()) return -1;
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), timestampMs,
+                               [](const Entry &e, qint64 t) { return e.timestampMs < t; });
+    int index = int(it - entries.begin());
+    if (index == entries.size()) return index - 1;
+    if (index > 0 && timestampMs - entries[index - 1].timestampMs < entries[index].timestampMs - timestampMs) {
+        return index - 1;
+    }
+    return index;
+}
+
+SystemSnapshot SnapshotHistory::snapshotAt(int i) const
+{
+    const Entry &entry = entries[i];
+    SystemSnapshot snapshot;
+    snapshot.timestampMs = entry.timestampMs;
+    snapshot.mounts = entry.mounts;
+    snapshot.interfaces = entry.interfaces;
+    snapshot.cgroupLimits = entry.cgroupLimits;
+
+    if (i == entries.size() - 1) {
+        snapshot.processes = last;
+        return snapshot;
+    }
+
+    // Volta ao quadro completo e reaplica as diferenças até i
+    int k = i;
+    while (k > 0 && !entries[k].keyframe) --k;
+    QVector<SnapshotProcess> table = decode(QVector<SnapshotProcess>(), entries[k].processes);
+    for (++k; k <= i; ++k) {
+        table = decode(table, entries[k].processes);
+    }
+    snapshot.processes = table;
+    return snapshot;
+}
+
+qint64 SnapshotHistory::encodedBytes() const
+{
+    qint64 bytes = 0;
+    for (const Entry &entry : entries) bytes += entry.processes.size();
+    return bytes;
+}
@@ -0,0 +1,113 @@
+#ifndef SNAPSHOTHISTORY_H
+#define SNAPSHOTHISTORY_H
+
+#include <QByteArray>
+#include <QVector>
+#include "processstats.h"
+#include "filesystemstats.h"
+
+struct SnapshotProcess
+{
+    int pid = 0;
+    quint64 startTime = 0;
+    quint64 rssKb = 0;
+    quint64 cpuTicks = 0;
+    QByteArray name;
+};
+
+// Item genérico ordenado por chave: montagem, interface ou limite de cgroup
+struct SnapshotItem
+{
+    QByteArray key;
+    QByteArray value;
+};
+
+// Estado completo da máquina num instante; todas as listas ordenadas pela
+// chave (pid ou key) para que comparar dois estados seja um merge linear
+struct SystemSnapshot
+{
+    qint64 timestampMs = 0;
+    QVector<SnapshotProcess> processes;
+    QVector<SnapshotItem> mounts;
+    QVector<SnapshotItem> interfaces;
+    QVector<SnapshotItem> cgroupLimits;
+};
+
+struct SnapshotDiff
+{
+    struct Growth
+    {
+        SnapshotProcess before;
+        SnapshotProcess after;
+        double cpuPercent = 0.0;   // média entre os dois instantes
+    };
+    // before vazio = item novo; after vazio = item removido
+    struct ItemChange
+    {
+        QByteArray key;
+        QByteArray before;
+        QByteArray after;
+    };
+
+    QVector<SnapshotProcess> appeared;
+    QVector<SnapshotProcess> disappeared;
+    QVector<Growth> rssGrowth;     // maior crescimento primeiro
+    QVector<Growth> cpuUsage;      // maior consumo primeiro
+    QVector<ItemChange> mounts;
+    QVector<ItemChange> interfaces;
+    QVector<ItemChange> cgroupLimits;
+
+    static constexpr int MaxGrowthRows = 50;
+};
+
+// Monta um snapshot a partir da varredura de processos e das montagens já
+// coletadas; interfaces e limites de cgroup são lidos do /sys aqui
+SystemSnapshot captureSnapshot(qint64 timestampMs, const ProcessStats &processes,
+                               const FilesystemStats &filesystems);
+
+SnapshotDiff diffSnapshots(const SystemSnapshot &from, const SystemSnapshot &to);
+
+// Snapshots periódicos guardados compactos: a tabela de processos de cada
+// um é codificada (varints) como diferença para o anterior, com um quadro
+// completo a cada KeyframeInterval. As listas pequenas são QVector
+// implicitamente compartilhados, então repetir uma lista igual não copia.
+class SnapshotHistory
+{
+public:
+    explicit SnapshotHistory(int capacity = 1440);
+
+    void append(const SystemSnapshot &snapshot);
+
+    int size() const { return entries.size(); }
+    qint64 timestampAt(int i) const { return entries[i].timestampMs; }
+    // Índice do snapshot mais próximo de timestampMs, -1 se vazio
+    int indexNear(qint64 timestampMs) const;
+    SystemSnapshot snapshotAt(int i) const;
+    // Bytes das tabelas de processos codificadas
+    qint64 encodedBytes() const;
+
+    static constexpr int KeyframeInterval = 60;
+
+private:
+    struct Entry
+    {
+        qint64 timestampMs = 0;
+        bool keyframe = false;
+        QByteArray processes;
+        QVector<SnapshotItem> mounts;
+        QVector<SnapshotItem> interfaces;
+        QVector<SnapshotItem> cgroupLimits;
+    };
+
+    static QByteArray encode(const QVector<SnapshotProcess> &previous,
+                             const QVector<SnapshotProcess> &current);
+    static QVector<SnapshotProcess> decode(const QVector<SnapshotProcess> &previous,
+                                           const QByteArray &delta);
+
+    QVector<Entry> entries;
+    QVector<SnapshotProcess> last;   // tabela do snapshot mais novo, já decodificada
+    int capacity;
+    int sinceKeyframe;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "snapshotpublisher.h"
+#include <QDebug>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <cerrno>
+
+SnapshotPublisher::SnapshotPublisher()
+    : name(snapshotShmName()), fd(-1), layout(nullptr)
+{
+    fd = shm_open(name.constData(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        qWarning() << "Memória compartilhada indisponível:" << name;
+        return;
+    }
+
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        // Outro monitor já publica neste nome
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    if (ftruncate(fd, sizeof(SnapshotShmLayout)) != 0) {
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    void *addr = mmap(nullptr, sizeof(SnapshotShmLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        close(fd);
+        fd = -1;
+        return;
+    }
+
+    layout = static_cast<SnapshotShmLayout *>(addr);
+    layout->sequence.store(0, std::memory_order_relaxed);
+    layout->payloadSize = sizeof(SnapshotShmPayload);
+    layout->version = SnapshotShmVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    layout->magic = SnapshotShmMagic;
+}
+
+SnapshotPublisher::~SnapshotPublisher()
+{
+    if (layout) {
+        // Leitores ainda mapeados veem o magic zerado e reabrem o nome
+        layout->magic = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        munmap(layout, sizeof(SnapshotShmLayout));
+        shm_unlink(name.constData());
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+void SnapshotPublisher::publish(const SnapshotShmPayload &payload)
+{
+    if (!layout) return;
+
+    uint32_t seq = layout->sequence.load(std::memory_order_relaxed);
+    layout->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&layout->payload, &payload, sizeof(payload));
+
+    layout->sequence.store(seq + 2, std::memory_order_release);
+}
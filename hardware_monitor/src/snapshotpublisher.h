@@ -0,0 +1,27 @@
+#ifndef SNAPSHOTPUBLISHER_H
+#define SNAPSHOTPUBLISHER_H
+
+#include <QByteArray>
+#include "snapshotshm.h"
+
+// Lado escritor do segmento descrito em snapshotshm.h. Só uma instância por
+// máquina publica: as demais encontram o flock ocupado e ficam inativas.
+class SnapshotPublisher
+{
+public:
+    SnapshotPublisher();
+    ~SnapshotPublisher();
+
+    SnapshotPublisher(const SnapshotPublisher &) = delete;
+    SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+
+    bool isActive() const { return layout != nullptr; }
+    void publish(const SnapshotShmPayload &payload);
+
+private:
+    QByteArray name;
+    int fd;
+    SnapshotShmLayout *layout;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef SNAPSHOTSHM_H
+#define SNAPSHOTSHM_H
+
+// Layout do snapshot publicado em memória compartilhada POSIX e um leitor
+// header-only. Não depende de Qt: outros processos locais só incluem este
+// arquivo e leem CPU/RAM/PSI sem nenhuma syscall por leitura.
+//
+//     SnapshotShmReader reader;
+//     SnapshotShmPayload snap;
+//     if (reader.read(snap)) { ... snap.cpuUsage ... }
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SnapshotShmDefaultName[] = "/hwmon-snapshot";
+static const uint32_t SnapshotShmMagic = 0x4e4d5748; // "HWMN"
+static const uint32_t SnapshotShmVersion = 1;
+
+struct SnapshotShmPayload
+{
+    int64_t timestampMs;      // CLOCK_REALTIME da amostra
+    int32_t sampleIntervalMs; // cadência atual do publicador
+    int32_t reserved;
+    double cpuUsage;          // %
+    double memUsage;          // %
+    double psiCpuSome;        // avg10 de /proc/pressure/*
+    double psiMemorySome;
+    double psiMemoryFull;
+    double psiIoSome;
+    double psiIoFull;
+};
+
+struct SnapshotShmLayout
+{
+    uint32_t magic;
+    uint32_t version;
+    // Seqlock: ímpar enquanto o publicador escreve o payload
+    std::atomic<uint32_t> sequence;
+    uint32_t payloadSize;
+    SnapshotShmPayload payload;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "seqlock precisa de atomics sem lock para funcionar entre processos");
+
+// Nome do segmento: HWMON_SHM_NAME sobrescreve o padrão
+inline const char *snapshotShmName()
+{
+    const char *name = std::getenv("HWMON_SHM_NAME");
+    return (name && name[0] == '/') ? name : SnapshotShmDefaultName;
+}
+
+class SnapshotShmReader
+{
+public:
+    explicit SnapshotShmReader(const char *name = snapshotShmName())
+        : fd(-1), layout(nullptr)
+    {
+        std::strncpy(segmentName, name, sizeof(segmentName) - 1);
+        segmentName[sizeof(segmentName) - 1] = '\0';
+        open();
+    }
+
+    ~SnapshotShmReader()
+    {
+        unmap();
+    }
+
+    SnapshotShmReader(const SnapshotShmReader &) = delete;
+    SnapshotShmReader &operator=(const SnapshotShmReader &) = delete;
+
+    bool isOpen() const { return layout != nullptr; }
+
+    // Copia o último snapshot consistente. Falha se o segmento não existe,
+    // tem outra versão, ou o publicador não terminou de escrever após várias
+    // tentativas (nunca bloqueia). Se o publicador saiu e removeu o
+    // segmento, a próxima chamada reabre o nome, que pode já ser de um
+    // publicador novo.
+    bool read(SnapshotShmPayload &out)
+    {
+        if (!layout || layout->magic != SnapshotShmMagic) {
+            // Só quando não há dados válidos: o caminho normal continua sem syscall
+            if (!layout || isUnlinked()) {
+                unmap();
+                open();
+            }
+            if (!layout || layout->magic != SnapshotShmMagic) return false;
+        }
+        if (layout->version != SnapshotShmVersion) return false;
+
+        for (int attempt = 0; attempt < 64; ++attempt) {
+            uint32_t before = layout->sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+
+            std::memcpy(&out, const_cast<const SnapshotShmPayload *>(&layout->payload), sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (layout->sequence.load(std::memory_order_relaxed) == before) {
+                return before != 0; // 0 = nada publicado ainda
+            }
+        }
+        return false;
+    }
+
+private:
+    void open()
+    {
+        fd = shm_open(segmentName, O_RDONLY, 0);
+        if (fd < 0) return;
+
+        // Entre o shm_open(O_CREAT) e o ftruncate do publicador o segmento
+        // tem tamanho 0; mapear e ler daria SIGBUS
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(SnapshotShmLayout))) {
+            close(fd);
+            fd = -1;
+            return;
+        }
+
+        void *addr = mmap(nullptr, sizeof(SnapshotShmLayout), PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            fd = -1;
+            return;
+        }
+        layout = static_cast<const SnapshotShmLayout *>(addr);
+    }
+
+    void unmap()
+    {
+        if (layout) {
+            munmap(const_cast<SnapshotShmLayout *>(layout), sizeof(SnapshotShmLayout));
+            layout = nullptr;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    // O publicador zera o magic e faz shm_unlink ao sair; o mapeamento
+    // antigo continua válido, mas ninguém mais escreve nele
+    bool isUnlinked() const
+    {
+        struct stat st;
+        return fstat(fd, &st) != 0 || st.st_nlink == 0;
+    }
+
+    char segmentName[256];
+    int fd;
+    const SnapshotShmLayout *layout;
+};
+
+#endif
@@ -0,0 +1,270 @@
+#include "socketstats.h"
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// "Tcp: RtoAlgorithm RtoMin ... RetransSegs ..." seguido de "Tcp: 1 200 ...":
+// o valor está na mesma posição do nome na linha de cabeçalho
+bool findCounter(const char *p, const char *end, const char *prefix, const char *name,
+                 quint64 *value)
+{
+    const int prefixLength = int(std::strlen(prefix));
+    const int nameLength = int(std::strlen(name));
+    while (p < end) {
+        const char *lineEnd = nextLine(p, end);
+        if (lineEnd - p > prefixLength && std::memcmp(p, prefix, prefixLength) == 0) {
+            const char *values = lineEnd;
+            const char *valuesEnd = nextLine(values, end);
+            if (valuesEnd - values <= prefixLength || std::memcmp(values, prefix, prefixLength) != 0) {
+                return false;
+            }
+
+            const char *h = p + prefixLength;
+            const char *v = values + prefixLength;
+            for (;;) {
+                h = skipSpaces(h, lineEnd);
+                v = skipSpaces(v, valuesEnd);
+                if (h >= lineEnd || *h == '\n') return false;
+                const char *hEnd = skipToken(h, lineEnd);
+                if (hEnd - h == nameLength && std::memcmp(h, name, nameLength) == 0) {
+                    parseUInt(v, valuesEnd, value);
+                    return true;
+                }
+                h = hEnd;
+                v = skipToken(v, valuesEnd);
+            }
+        }
+        p = lineEnd;
+    }
+    return false;
+}
+
+const char *parseHex(const char *p, const char *end, quint32 *value)
+{
+    quint32 v = 0;
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c >= '0' && c <= '9') v = v * 16 + quint32(c - '0');
+        else if (c >= 'A' && c <= 'F') v = v * 16 + quint32(c - 'A' + 10);
+        else if (c >= 'a' && c <= 'f') v = v * 16 + quint32(c - 'a' + 10);
+        else break;
+    }
+    *value = v;
+    return p;
+}
+
+double perSecond(quint64 current, quint64 previous, double seconds)
+{
+    return current >= previous && seconds > 0.0 ? (current - previous) / seconds : 0.0;
+}
+
+}
+
+SocketStats::SocketStats()
+    : netlinkFd(-1), sequence(0), snmp("/proc/net/snmp"), netstat("/proc/net/netstat"),
+      primed(false)
+{
+    netlinkFd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    buffer.resize(65536);
+}
+
+SocketStats::~SocketStats()
+{
+    if (netlinkFd >= 0) close(netlinkFd);
+}
+
+const char *SocketStats::stateName(int state)
+{
+    static const char *const names[SocketCounts::StateCount] = {
+        nullptr, "ESTABLISHED", "SYN_SENT", "SYN_RECV", "FIN_WAIT1", "FIN_WAIT2", "TIME_WAIT",
+        "CLOSE", "CLOSE_WAIT", "LAST_ACK", "LISTEN", "CLOSING", "NEW_SYN_RECV"
+    };
+    return state >= 0 && state < SocketCounts::StateCount ? names[state] : nullptr;
+}
+
+bool SocketStats::dumpNetlink(int family, int protocol, SocketCounts *counts)
+{
+    struct
+    {
+        nlmsghdr header;
+        inet_diag_req_v2 request;
+    } message;
+    std::memset(&message, 0, sizeof(message));
+    message.header.nlmsg_len = sizeof(message);
+    message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    message.header.nlmsg_seq = ++sequence;
+    message.request.sdiag_family = quint8(family);
+    message.request.sdiag_protocol = quint8(protocol);
+    message.request.idiag_states = ~0u;
+    // idiag_ext = 0: sem tcp_info nem memória, só o registro fixo
+
+    sockaddr_nl kernel;
+    std::memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(netlinkFd, &message, sizeof(message), 0,
+               reinterpret_cast<sockaddr *>(&kernel), sizeof(kernel)) < 0) {
+        return false;
+    }
+
+    for (;;) {
+        ssize_t n = recv(netlinkFd, buffer.data(), buffer.size(), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+
+        int remaining = int(n);
+        for (const nlmsghdr *h = reinterpret_cast<const nlmsghdr *>(buffer.constData());
+             NLMSG_OK(h, remaining); h = NLMSG_NEXT(h, remaining)) {
+            if (h->nlmsg_seq != sequence) continue;   // resto de um dump abortado
+            if (h->nlmsg_type == NLMSG_DONE) return true;
+            if (h->nlmsg_type == NLMSG_ERROR) return false;
+            if (h->nlmsg_type != SOCK_DIAG_BY_FAMILY
+                    || h->nlmsg_len < NLMSG_LENGTH(sizeof(inet_diag_msg))) {
+                continue;
+            }
+
+            const inet_diag_msg *diag = static_cast<const inet_diag_msg *>(NLMSG_DATA(h));
+            if (protocol == IPPROTO_UDP) {
+                ++counts->udpTotal;
+                continue;
+            }
+
+            ++counts->tcpTotal;
+            if (diag->idiag_state < SocketCounts::StateCount) {
+                ++counts->tcpStates[diag->idiag_state];
+            }
+            // Em LISTEN: rqueue = fila de accept atual, wqueue = backlog
+            if (diag->idiag_state == TCP_LISTEN) {
+                counts->listenQueued += diag->idiag_rqueue;
+                if (diag->idiag_rqueue > diag->idiag_wqueue) ++counts->listenersFull;
+            }
+        }
+    }
+}
+
+bool SocketStats::scanProcFile(const char *path, bool tcp, SocketCounts *counts)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    // Blocos de tamanho fixo; a linha partida no fim passa para o próximo
+    int carry = 0;
+    bool header = true;
+    for (;;) {
+        ssize_t n = read(fd, buffer.data() + carry, buffer.size() - carry);
+        if (n <= 0) break;
+
+        const char *p = buffer.constData();
+        const char *end = p + carry + n;
+        while (const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p))) {
+            if (header) {
+                header = false;
+            } else if (!tcp) {
+                ++counts->udpTotal;
+            } else {
+                // "  12: 0100007F:0277 00000000:0000 0A 00000000:00000003 ..."
+                const char *q = skipSpaces(p, lineEnd);
+                q = skipSpaces(skipToken(q, lineEnd), lineEnd);   // sl
+                q = skipSpaces(skipToken(q, lineEnd), lineEnd);   // local
+                q = skipSpaces(skipToken(q, lineEnd), lineEnd);   // remoto
+                quint32 state = 0;
+                q = skipSpaces(parseHex(q, lineEnd, &state), lineEnd);
+                ++counts->tcpTotal;
+                if (state < quint32(SocketCounts::StateCount)) ++counts->tcpStates[state];
+                if (state == TCP_LISTEN) {
+                    quint32 txQueue = 0;
+                    quint32 rxQueue = 0;
+                    q = parseHex(q, lineEnd, &txQueue);
+                    if (q < lineEnd && *q == ':') parseHex(q + 1, lineEnd, &rxQueue);
+                    counts->listenQueued += rxQueue;
+                }
+            }
+            p = lineEnd + 1;
+        }
+
+        carry = int(end - p);
+        if (carry == buffer.size()) carry = 0;   // linha maior que o bloco: descarta
+        std::memmove(buffer.data(), p, carry);
+    }
+    close(fd);
+    return true;
+}
+
+void SocketStats::readCounters(double seconds)
+{
+    Counters current = previous;
+    if (snmp.read()) {
+        const char *end = snmp.end();
+        findCounter(snmp.begin(), end, "Tcp:", "OutSegs", &current.outSegs);
+        findCounter(snmp.begin(), end, "Tcp:", "RetransSegs", &current.retransSegs);
+        findCounter(snmp.begin(), end, "Tcp:", "ActiveOpens", &current.activeOpens);
+        findCounter(snmp.begin(), end, "Tcp:", "PassiveOpens", &current.passiveOpens);
+    }
+    if (netstat.read()) {
+        const char *end = netstat.end();
+        findCounter(netstat.begin(), end, "TcpExt:", "ListenOverflows", &current.listenOverflows);
+        findCounter(netstat.begin(), end, "TcpExt:", "ListenDrops", &current.listenDrops);
+    }
+
+    if (primed) {
+        tcpRates.outSegsPerSec = perSecond(current.outSegs, previous.outSegs, seconds);
+        tcpRates.retransSegsPerSec = perSecond(current.retransSegs, previous.retransSegs, seconds);
+        tcpRates.retransPercent = tcpRates.outSegsPerSec > 0.0
+                                      ? 100.0 * tcpRates.retransSegsPerSec / tcpRates.outSegsPerSec
+                                      : 0.0;
+        tcpRates.listenOverflowsPerSec = perSecond(current.listenOverflows, previous.listenOverflows,
+                                                   seconds);
+        tcpRates.listenDropsPerSec = perSecond(current.listenDrops, previous.listenDrops, seconds);
+        tcpRates.activeOpensPerSec = perSecond(current.activeOpens, previous.activeOpens, seconds);
+        tcpRates.passiveOpensPerSec = perSecond(current.passiveOpens, previous.passiveOpens, seconds);
+    }
+    previous = current;
+    primed = true;
+}
+
+void SocketStats::sample()
+{
+    double seconds = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) clock.start();
+
+    SocketCounts counts;
+    bool udpDone = false;
+    if (netlinkFd >= 0) {
+        if (dumpNetlink(AF_INET, IPPROTO_TCP, &counts)) {
+            // Sem IPv6 ou sem udp_diag o restante continua valendo
+            dumpNetlink(AF_INET6, IPPROTO_TCP, &counts);
+            udpDone = dumpNetlink(AF_INET, IPPROTO_UDP, &counts);
+            if (udpDone) {
+                dumpNetlink(AF_INET6, IPPROTO_UDP, &counts);
+            } else {
+                counts.udpTotal = 0;
+            }
+        } else {
+            // sock_diag indisponível: /proc daqui em diante
+            close(netlinkFd);
+            netlinkFd = -1;
+            counts = SocketCounts();
+        }
+    }
+
+    if (netlinkFd < 0) {
+        scanProcFile("/proc/net/tcp", true, &counts);
+        scanProcFile("/proc/net/tcp6", true, &counts);
+    }
+    if (!udpDone) {
+        scanProcFile("/proc/net/udp", false, &counts);
+        scanProcFile("/proc/net/udp6", false, &counts);
+    }
+
+    socketCounts = counts;
+    readCounters(seconds);
+}
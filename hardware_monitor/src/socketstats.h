@@ -0,0 +1,85 @@
+#ifndef SOCKETSTATS_H
+#define SOCKETSTATS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include "procreader.h"
+
+// Contagem de sockets por estado, sem texto no caminho principal
+struct SocketCounts
+{
+    static constexpr int StateCount = 13;   // TCP_ESTABLISHED (1) .. TCP_NEW_SYN_RECV (12)
+
+    quint32 tcpStates[StateCount] = {};
+    quint32 tcpTotal = 0;
+    quint32 udpTotal = 0;
+    quint32 listenQueued = 0;    // conexões esperando accept() em todos os listeners
+    quint32 listenersFull = 0;   // listeners com a fila de accept cheia (só netlink)
+};
+
+// Taxas de /proc/net/snmp (Tcp:) e /proc/net/netstat (TcpExt:)
+struct TcpRates
+{
+    double outSegsPerSec = 0.0;
+    double retransSegsPerSec = 0.0;
+    double retransPercent = 0.0;        // retransmitidos / enviados
+    double listenOverflowsPerSec = 0.0; // SYN/ACK sem lugar na fila de accept
+    double listenDropsPerSec = 0.0;
+    double activeOpensPerSec = 0.0;
+    double passiveOpensPerSec = 0.0;
+};
+
+// Sockets TCP/UDP por estado via NETLINK_SOCK_DIAG: o kernel devolve um
+// inet_diag_msg binário por socket e só o byte de estado e as filas são
+// olhados. Sem sock_diag (módulo ausente, seccomp) cai para
+// /proc/net/{tcp,tcp6,udp,udp6}, lidos em blocos de tamanho fixo e
+// varridos sem montar strings, para aguentar centenas de milhares de
+// conexões.
+class SocketStats
+{
+public:
+    enum Source { Netlink, ProcFiles };
+
+    SocketStats();
+    ~SocketStats();
+
+    SocketStats(const SocketStats &) = delete;
+    SocketStats &operator=(const SocketStats &) = delete;
+
+    void sample();
+
+    Source source() const { return netlinkFd >= 0 ? Netlink : ProcFiles; }
+    const SocketCounts &counts() const { return socketCounts; }
+    const TcpRates &rates() const { return tcpRates; }
+
+    // "ESTABLISHED", "TIME_WAIT"...; nullptr para índices sem estado
+    static const char *stateName(int state);
+
+private:
+    struct Counters
+    {
+        quint64 outSegs = 0;
+        quint64 retransSegs = 0;
+        quint64 listenOverflows = 0;
+        quint64 listenDrops = 0;
+        quint64 activeOpens = 0;
+        quint64 passiveOpens = 0;
+    };
+
+    bool dumpNetlink(int family, int protocol, SocketCounts *counts);
+    bool scanProcFile(const char *path, bool tcp, SocketCounts *counts);
+    void readCounters(double seconds);
+
+    int netlinkFd;
+    quint32 sequence;
+    QByteArray buffer;
+    ProcReader snmp;
+    ProcReader netstat;
+    SocketCounts socketCounts;
+    TcpRates tcpRates;
+    Counters previous;
+    bool primed;
+    QElapsedTimer clock;
+};
+
+#endif
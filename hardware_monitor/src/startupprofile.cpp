@@ -0,0 +1,73 @@
+#include "startupprofile.h"
+#include "procreader.h"
+#include <QElapsedTimer>
+#include <QVector>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+namespace {
+
+bool enabled = false;
+double startOffsetMs = 0.0;    // da criação do processo até enable()
+double lastMs = 0.0;
+QElapsedTimer sinceEnable;
+QVector<const char *> marked;
+
+// Milissegundos desde a criação do processo, pelo campo 22 de
+// /proc/self/stat (em ticks desde o boot) contra CLOCK_BOOTTIME
+double msSinceProcessStart()
+{
+    ProcReader stat("/proc/self/stat");
+    if (!stat.read()) return 0.0;
+
+    // O comm pode ter espaços e parênteses: os campos começam depois do último ')'
+    const char *p = stat.end();
+    while (p > stat.begin() && p[-1] != ')') --p;
+    for (int field = 3; field < 22 && p < stat.end(); ++field) {
+        p = skipToken(skipSpaces(p, stat.end()), stat.end());
+    }
+    quint64 ticks = 0;
+    parseUInt(skipSpaces(p, stat.end()), stat.end(), &ticks);
+    if (ticks == 0) return 0.0;
+
+    timespec now;
+    clock_gettime(CLOCK_BOOTTIME, &now);
+    double nowMs = now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+    double startMs = ticks * 1000.0 / sysconf(_SC_CLK_TCK);
+    return nowMs > startMs ? nowMs - startMs : 0.0;
+}
+
+}
+
+namespace StartupProfile {
+
+void enable()
+{
+    if (enabled) return;
+    enabled = true;
+    sinceEnable.start();
+    startOffsetMs = msSinceProcessStart();
+    lastMs = 0.0;
+}
+
+bool isEnabled()
+{
+    return enabled;
+}
+
+void mark(const char *phase)
+{
+    if (!enabled) return;
+    for (const char *done : marked) {
+        if (std::strcmp(done, phase) == 0) return;
+    }
+    marked.append(phase);
+
+    double ms = startOffsetMs + sinceEnable.nsecsElapsed() / 1e6;
+    std::fprintf(stderr, "inicialização: %-26s %8.1f ms  (+%.1f ms)\n", phase, ms, ms - lastMs);
+    lastMs = ms;
+}
+
+}
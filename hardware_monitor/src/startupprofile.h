@@ -0,0 +1,16 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+// Tempos da inicialização do monitor, ligados por --profile-startup. A
+// referência é o instante em que o kernel criou o processo (starttime de
+// /proc/self/stat), então o carregamento das bibliotecas e os construtores
+// estáticos entram na conta; cada fase vai para o stderr assim que é
+// marcada, com o total e o delta desde a fase anterior.
+namespace StartupProfile {
+void enable();
+bool isEnabled();
+// Sem efeito com o perfil desligado ou se a fase já foi marcada
+void mark(const char *phase);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "stringpool.h"
+#include <QHash>
+#include <cstring>
+
+StringPool::StringPool()
+    : blockUsed(BlockSize)
+{
+    entries.append(Entry{ "", 0, 0 });
+    buckets.fill(0, 1024);
+}
+
+const char *StringPool::store(const char *data, int size)
+{
+    char *dst;
+    if (size + 1 > BlockSize / 4) {
+        // Strings longas ganham um bloco próprio; o bloco corrente segue aberto
+        int at = qMax(0, blocks.size() - 1);
+        blocks.insert(at, QByteArray(size + 1, Qt::Uninitialized));
+        dst = blocks[at].data();
+    } else {
+        if (size + 1 > BlockSize - blockUsed) {
+            blocks.append(QByteArray(BlockSize, Qt::Uninitialized));
+            blockUsed = 0;
+        }
+        dst = blocks.last().data() + blockUsed;
+        blockUsed += size + 1;
+    }
+
+    std::memcpy(dst, data, size);
+    dst[size] = '\0';
+    return dst;
+}
+
+quint32 StringPool::intern(const char *data, int size)
+{
+    if (size <= 0) return 0;
+
+    uint hash = qHashBits(data, size);
+    int mask = buckets.size() - 1;
+    for (int i = hash & mask;; i = (i + 1) & mask) {
+        quint32 id = buckets[i];
+        if (id == 0) {
+            id = entries.size();
+            entries.append(Entry{ store(data, size), size, hash });
+            buckets[i] = id;
+            // Carga máxima de 1/2 mantém as sondagens curtas
+            if (entries.size() * 2 > buckets.size()) {
+                rehash(buckets.size() * 2);
+            }
+            return id;
+        }
+        const Entry &entry = entries[id];
+        if (entry.hash == hash && entry.length == size
+            && std::memcmp(entry.data, data, size) == 0) {
+            return id;
+        }
+    }
+}
+
+void StringPool::rehash(int bucketCount)
+{
+    buckets.fill(0, bucketCount);
+    int mask = bucketCount - 1;
+    for (int id = 1; id < entries.size(); ++id) {
+        int i = entries[id].hash & mask;
+        while (buckets[i] != 0) i = (i + 1) & mask;
+        buckets[i] = id;
+    }
+}
+
+qint64 StringPool::memoryBytes() const
+{
+    qint64 bytes = 0;
+    for (const QByteArray &block : blocks) bytes += block.size();
+    return bytes + entries.capacity() * sizeof(Entry) + buckets.capacity() * sizeof(quint32);
+}
+
+void StringPool::swap(StringPool &other)
+{
+    blocks.swap(other.blocks);
+    qSwap(blockUsed, other.blockUsed);
+    entries.swap(other.entries);
+    buckets.swap(other.buckets);
+}
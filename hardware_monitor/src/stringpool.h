@@ -0,0 +1,53 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Tabela de strings internadas: cada texto distinto é guardado uma vez num
+// arena de blocos fixos e identificado por um id de 32 bits. Comparar ou
+// agrupar por id é comparar inteiros. O id 0 é sempre a string vazia.
+class StringPool
+{
+public:
+    StringPool();
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    quint32 intern(const char *data, int size);
+    quint32 intern(const QByteArray &text) { return intern(text.constData(), text.size()); }
+
+    // Ponteiro estável enquanto o pool viver; terminado em NUL
+    const char *data(quint32 id) const { return entries[id].data; }
+    int length(quint32 id) const { return entries[id].length; }
+    QString string(quint32 id) const { return QString::fromUtf8(entries[id].data, entries[id].length); }
+
+    int count() const { return entries.size(); }
+    // Bytes ocupados pelo arena, pela tabela hash e pelos descritores
+    qint64 memoryBytes() const;
+
+    void swap(StringPool &other);
+
+private:
+    struct Entry
+    {
+        const char *data;
+        int length;
+        uint hash;
+    };
+
+    static constexpr int BlockSize = 64 * 1024;
+
+    const char *store(const char *data, int size);
+    void rehash(int bucketCount);
+
+    QVector<QByteArray> blocks;
+    int blockUsed;
+    QVector<Entry> entries;
+    QVector<quint32> buckets;   // endereçamento aberto; 0 = livre (id 0 nunca entra)
+};
+
+#endif
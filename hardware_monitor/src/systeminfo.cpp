@@ -4,18 +4,263 @@
 #include <QStringList>
 #include <QDebug>
 #include <QProcess>
+#include <QDir>
+#include <QDateTime>
+#include <QCoreApplication>
+#include <QtAlgorithms>
+#include <sys/prctl.h>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace {
+
+// "0.12" sem montar string; o PSI só tem dígitos, ponto e dígitos
+double parseDecimal(const char *p, const char *end)
+{
+    quint64 integer = 0;
+    p = parseUInt(p, end, &integer);
+    double value = double(integer);
+    if (p < end && *p == '.') {
+        double scale = 0.1;
+        for (++p; p < end && (unsigned)(*p - '0') < 10; ++p, scale *= 0.1) {
+            value += (*p - '0') * scale;
+        }
+    }
+    return value;
+}
+
+}
 
 SystemInfo::SystemInfo(QObject *parent)
-    : QObject(parent), previousIdle(0), previousTotal(0)
+    : QObject(parent), statReader("/proc/stat"), meminfoReader("/proc/meminfo"),
+      cpuPressureReader("/proc/pressure/cpu"), memoryPressureReader("/proc/pressure/memory"),
+      ioPressureReader("/proc/pressure/io"), previousIdle(0), previousTotal(0), snapshotVersion(0),
+      windowVisible(false), onBattery(false), activeCollectors(0),
+      visibleIntervalMs(VisibleIntervalMs), processEventsNotifier(nullptr),
+      historyLog(MetricLog::defaultDirectory(),
+                 publisher.isActive() ? MetricLog::Write : MetricLog::ReadOnly)
 {
+    qRegisterMetaType<Snapshot>();
+
+    cpuSeries = history.addSeries("cpu");
+    memSeries = history.addSeries("mem");
+    fsSeriesGeneration = ~0u;
+    diskSeriesGeneration = ~0u;
+    runqDelaySeries = history.addSeries("runq_delay", QString(), false);
+
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &SystemInfo::updateStats);
-    timer->start(1000); // Atualiza a cada segundo
+    bootstrapTimer = new QTimer(this);
+    bootstrapTimer->setSingleShot(true);
+    bootstrapTimer->setTimerType(Qt::PreciseTimer);
+    connect(bootstrapTimer, &QTimer::timeout, this, &SystemInfo::updateStats);
+
+    // A varredura de snapshots não mostra descritores; a da aba Processos
+    // usa o orçamento padrão ou o de $HWMON_FD_BUDGET
+    snapshotProcesses.setDescriptorBudget(0);
+    bool budgetSet = false;
+    int budget = qEnvironmentVariableIntValue("HWMON_FD_BUDGET", &budgetSet);
+    if (budgetSet) processStats.setDescriptorBudget(budget);
+
+    // Dias de amostras brutas no histórico em disco; os níveis resumidos
+    // ficam proporcionalmente mais
+    bool daysSet = false;
+    int days = qEnvironmentVariableIntValue("HWMON_HISTORY_DAYS", &daysSet);
+    if (daysSet && days > 0) historyLog.setRawRetentionMs(qint64(days) * 86400000);
+
+    // Base do delta de /proc/stat já na construção: a primeira amostra,
+    // ~100 ms depois, tem CPU válida em vez de esperar dois ticks
+    calculateCpuUsage();
+
+    onBattery = detectBatteryPower();
+    powerCheckClock.start();
+    applySamplingCadence();
+}
+
+SystemInfo *SystemInfo::instance()
+{
+    // Filho da aplicação: destruído (e o log gravado) quando ela termina
+    static SystemInfo *service = nullptr;
+    if (!service) {
+        service = new SystemInfo(QCoreApplication::instance());
+    }
+    return service;
+}
+
+void SystemInfo::subscribe(QObject *subscriber, int collectors, int intervalMs)
+{
+    if (!subscriptions.contains(subscriber)) {
+        connect(subscriber, &QObject::destroyed, this, [this, subscriber]() {
+            unsubscribe(subscriber);
+        });
+    }
+    Subscription &subscription = subscriptions[subscriber];
+    subscription.collectors = collectors;
+    subscription.intervalMs = qMax(100, intervalMs);
+    updateSubscriptions();
+}
+
+void SystemInfo::setSubscriberVisible(QObject *subscriber, bool visible)
+{
+    auto it = subscriptions.find(subscriber);
+    if (it == subscriptions.end() || it->visible == visible) return;
+    it->visible = visible;
+    updateSubscriptions();
+}
+
+void SystemInfo::unsubscribe(QObject *subscriber)
+{
+    if (subscriptions.remove(subscriber) > 0) {
+        disconnect(subscriber, &QObject::destroyed, this, nullptr);
+        updateSubscriptions();
+    }
+}
+
+void SystemInfo::updateSubscriptions()
+{
+    bool visible = false;
+    int active = 0;
+    int interval = std::numeric_limits<int>::max();
+    for (int i = 0; i < CollectorCount; ++i) {
+        collectorIntervals[i] = std::numeric_limits<int>::max();
+    }
+
+    // Assinantes ocultos não pedem nada além do histórico
+    for (const Subscription &subscription : subscriptions) {
+        if (!subscription.visible) continue;
+        visible = true;
+        active |= subscription.collectors;
+        interval = qMin(interval, subscription.intervalMs);
+        for (int i = 0; i < CollectorCount; ++i) {
+            if (subscription.collectors & (1 << i)) {
+                collectorIntervals[i] = qMin(collectorIntervals[i], subscription.intervalMs);
+            }
+        }
+    }
+
+    // Coletor sem assinante para de vez; perf_event fecha os descritores
+    for (int i = 0; i < CollectorCount; ++i) {
+        if ((active & (1 << i)) && !(activeCollectors & (1 << i))) {
+            collectorClocks[i].invalidate();
+        }
+    }
+    if ((active & PerfCollector) && !perfCounters.isOpen()) {
+        // Leitura base já na abertura: o primeiro tick tem deltas
+        if (perfCounters.open()) perfCounters.sample();
+    } else if (!(active & PerfCollector) && perfCounters.isOpen()) {
+        perfCounters.close();
+    }
+    if ((active & ProcessesCollector) && !processEvents.isOpen()) {
+        processEvents.open();
+        if (processEvents.handle() >= 0) {
+            processEventsNotifier = new QSocketNotifier(processEvents.handle(),
+                                                        QSocketNotifier::Read, this);
+            connect(processEventsNotifier, &QSocketNotifier::activated,
+                    this, &SystemInfo::drainProcessEvents);
+        }
+    } else if (!(active & ProcessesCollector) && processEvents.isOpen()) {
+        delete processEventsNotifier;
+        processEventsNotifier = nullptr;
+        processEvents.close();
+    }
+    activeCollectors = active;
+
+    bool appeared = visible && !windowVisible;
+    windowVisible = visible;
+    visibleIntervalMs = visible ? interval : VisibleIntervalMs;
+    if (appeared) {
+        // Ao (voltar a) aparecer, mostra um valor fresco sem esperar o próximo
+        // tick; fora do chamador, para não pesar na construção da janela
+        int wait = BootstrapDelayMs - int(cpuReadClock.elapsed());
+        bootstrapTimer->start(qMax(0, wait));
+    }
+    applySamplingCadence();
+}
+
+void SystemInfo::drainProcessEvents()
+{
+    // Sem permissão o kernel responde ao LISTEN com erro e o socket é
+    // fechado dentro do drain(): o notifier é desligado antes
+    processEventsNotifier->setEnabled(false);
+    processEvents.drain();
+    if (processEvents.handle() >= 0) {
+        processEventsNotifier->setEnabled(true);
+    } else {
+        processEventsNotifier->deleteLater();
+        processEventsNotifier = nullptr;
+    }
+}
+
+bool SystemInfo::collectorDue(Collector collector)
+{
+    if (!(activeCollectors & collector)) return false;
+    const int index = qCountTrailingZeroBits(uint(collector));
+
+    // Meio tick de folga: um coletor no mesmo ritmo do timer não pula ticks
+    QElapsedTimer &clock = collectorClocks[index];
+    if (clock.isValid() && clock.elapsed() < collectorIntervals[index] - timer->interval() / 2) {
+        return false;
+    }
+    clock.start();
+    return true;
+}
+
+void SystemInfo::applySamplingCadence()
+{
+    int interval = visibleIntervalMs;
+    if (!windowVisible) {
+        interval = onBattery ? BatteryHiddenIntervalMs : HiddenIntervalMs;
+    }
+
+    // Na bateria o timer vira "very coarse" (alinhado ao segundo) e a folga do
+    // thread aumenta, para o kernel agrupar os despertares com outros processos.
+    Qt::TimerType type = onBattery ? Qt::VeryCoarseTimer : Qt::CoarseTimer;
+    prctl(PR_SET_TIMERSLACK, onBattery ? 50000000UL : 0UL, 0, 0, 0);
+
+    // Reiniciar sem necessidade atrasaria o próximo tick a cada troca de aba
+    if (!timer->isActive() || timer->interval() != interval || timer->timerType() != type) {
+        timer->setTimerType(type);
+        timer->start(interval);
+    }
+}
+
+bool SystemInfo::detectBatteryPower()
+{
+    const QString base = "/sys/class/power_supply/";
+    bool hasBattery = false;
+    bool statusKnown = false;
+    bool discharging = false;
+    bool externalPower = false;
+
+    for (const QString &supply : QDir(base).entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        // Baterias de periféricos (mouse, teclado, fone sem fio) não
+        // alimentam o sistema
+        if (readFile(base + supply + "/scope").trimmed() == "Device") continue;
+
+        QString type = readFile(base + supply + "/type").trimmed();
+        if (type == "Battery") {
+            hasBattery = true;
+            QString status = readFile(base + supply + "/status").trimmed();
+            if (!status.isEmpty() && status != "Unknown") {
+                statusKnown = true;
+                if (status == "Discharging") discharging = true;
+            }
+        } else if (readFile(base + supply + "/online").trimmed() == "1") {
+            externalPower = true; // Mains/USB conectado
+        }
+    }
+
+    // O status da bateria do sistema vale mais que a ausência de fonte
+    // externa listada: desktops e VMs nem sempre expõem a Mains
+    if (statusKnown) return discharging;
+    return hasBattery && !externalPower;
 }
 
 QString SystemInfo::readFile(const QString &path)
 {
-    QFile file(path);
+    QFile file(QString::fromLocal8Bit(procPath(path.toLocal8Bit())));
     if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QTextStream in(&file);
         return in.readAll();
@@ -61,40 +306,88 @@ QString SystemInfo::getRamInfo()
 
 double SystemInfo::calculateCpuUsage()
 {
-    QString statContent = readFile("/proc/stat");
-    QStringList lines = statContent.split('\n');
+    if (!statReader.read()) return 0.0;
+    const char *p = statReader.begin();
+    const char *end = statReader.end();
 
-    if (lines.isEmpty()) return 0.0;
+    // "cpu  user nice system idle iowait irq softirq ...", depois uma "cpuN" por núcleo
+    auto parseCpuLine = [end](const char *line, long long *idle, long long *total) {
+        const char *lineEnd = nextLine(line, end);
+        const char *q = skipToken(line, lineEnd);
+        quint64 values[7] = {};
+        for (int v = 0; v < 7; ++v) {
+            const char *start = skipSpaces(q, lineEnd);
+            q = parseUInt(start, lineEnd, &values[v]);
+            if (q == start) return false;
+        }
+        *idle = (long long)(values[3] + values[4]);
+        *total = 0;
+        for (quint64 value : values) *total += (long long)value;
+        return true;
+    };
 
-    QString cpuLine = lines[0];
-    QStringList values = cpuLine.split(QRegExp("\\s+"));
+    long long currentIdle = 0;
+    long long currentTotal = 0;
+    if (end - p < 4 || std::memcmp(p, "cpu ", 4) != 0
+            || !parseCpuLine(p, &currentIdle, &currentTotal)) {
+        return 0.0;
+    }
 
-    if (values.size() < 5) return 0.0;
+    // Linhas "cpuN" vêm logo depois da agregada "cpu". CPUs offline não
+    // aparecem, então o índice é o N do token, não a posição da linha
+    for (int i = 0; i < coreUsages.size(); ++i) coreUsages[i] = 0.0;
+    int expected = 0;
+    for (p = nextLine(p, end); end - p > 3 && std::memcmp(p, "cpu", 3) == 0; p = nextLine(p, end)) {
+        quint64 number = 0;
+        const char *digits = p + 3;
+        if (parseUInt(digits, end, &number) == digits) break;
+        const int core = int(number);
 
-    long long user = values[1].toLongLong();
-    long long nice = values[2].toLongLong();
-    long long system = values[3].toLongLong();
-    long long idle = values[4].toLongLong();
-    long long iowait = values[5].toLongLong();
-    long long irq = values[6].toLongLong();
-    long long softirq = values[7].toLongLong();
+        long long idle = 0;
+        long long total = 0;
+        if (!parseCpuLine(p, &idle, &total)) break;
 
-    long long currentIdle = idle + iowait;
-    long long currentTotal = user + nice + system + idle + iowait + irq + softirq;
+        // Núcleos pulados desde a última linha ficaram offline: sem base
+        for (; expected < core && expected < coreUsages.size(); ++expected) {
+            previousCoreTotal[expected] = -1;
+        }
+        expected = core + 1;
+
+        while (core >= coreUsages.size()) {
+            previousCoreIdle.append(0);
+            previousCoreTotal.append(-1);
+            coreUsages.append(0.0);
+        }
+
+        // -1: núcleo novo ou que voltou agora; o delta sai no próximo tick
+        if (previousCoreTotal[core] >= 0) {
+            long long totalDiff = total - previousCoreTotal[core];
+            long long idleDiff = idle - previousCoreIdle[core];
+            coreUsages[core] = totalDiff > 0 ? 100.0 * (totalDiff - idleDiff) / totalDiff : 0.0;
+        }
+        previousCoreIdle[core] = idle;
+        previousCoreTotal[core] = total;
+    }
+    for (; expected < coreUsages.size(); ++expected) {
+        previousCoreTotal[expected] = -1;
+    }
 
     if (previousTotal == 0) {
         previousIdle = currentIdle;
         previousTotal = currentTotal;
+        cpuReadClock.start();
         return 0.0;
     }
 
     long long totalDiff = currentTotal - previousTotal;
     long long idleDiff = currentIdle - previousIdle;
+    if (totalDiff <= 0) return 0.0;
 
     double usage = 100.0 * (totalDiff - idleDiff) / totalDiff;
 
     previousIdle = currentIdle;
     previousTotal = currentTotal;
+    cpuReadClock.start();
 
     return usage;
 }
@@ -106,38 +399,255 @@ double SystemInfo::getCpuUsage()
 
 double SystemInfo::getMemoryUsage()
 {
-    QString memInfo = readFile("/proc/meminfo");
-    QStringList lines = memInfo.split('\n');
+    if (!meminfoReader.read()) return 0.0;
+    const char *end = meminfoReader.end();
 
-    long totalKb = 0, availableKb = 0;
-
-    for (const QString &line : lines) {
-        if (line.startsWith("MemTotal:")) {
-            QStringList parts = line.split(QRegExp("\\s+"));
-            if (parts.size() > 1) {
-                totalKb = parts[1].toLong();
-            }
-        } else if (line.startsWith("MemAvailable:")) {
-            QStringList parts = line.split(QRegExp("\\s+"));
-            if (parts.size() > 1) {
-                availableKb = parts[1].toLong();
-            }
+    quint64 totalKb = 0, availableKb = 0;
+    for (const char *p = meminfoReader.begin(); p < end; p = nextLine(p, end)) {
+        // "MemTotal:       16314124 kB"
+        if (end - p > 9 && std::memcmp(p, "MemTotal:", 9) == 0) {
+            parseUInt(skipSpaces(p + 9, end), end, &totalKb);
+        } else if (end - p > 13 && std::memcmp(p, "MemAvailable:", 13) == 0) {
+            parseUInt(skipSpaces(p + 13, end), end, &availableKb);
+            break;
         }
     }
 
-    if (totalKb > 0) {
-        long usedKb = totalKb - availableKb;
+    if (totalKb > 0 && availableKb <= totalKb) {
+        quint64 usedKb = totalKb - availableKb;
         return (double)usedKb / totalKb * 100.0;
     }
 
     return 0.0;
 }
 
+void SystemInfo::readPressureLine(ProcReader &reader, double *some, double *full)
+{
+    if (!reader.read()) return;
+    const char *end = reader.end();
+
+    for (const char *p = reader.begin(); p < end; p = nextLine(p, end)) {
+        // "some avg10=0.12 avg60=0.05 avg300=0.01 total=12345"
+        const char *lineEnd = nextLine(p, end);
+        const char *kind = p;
+        const char *q = skipSpaces(skipToken(p, lineEnd), lineEnd);
+        if (lineEnd - q < 6 || std::memcmp(q, "avg10=", 6) != 0) continue;
+
+        double value = parseDecimal(q + 6, lineEnd);
+        if (std::memcmp(kind, "some ", 5) == 0 && some) {
+            *some = value;
+        } else if (std::memcmp(kind, "full ", 5) == 0 && full) {
+            *full = value;
+        }
+    }
+}
+
+PressureStats SystemInfo::getPressure()
+{
+    PressureStats psi;
+    readPressureLine(cpuPressureReader, &psi.cpuSome, nullptr);
+    readPressureLine(memoryPressureReader, &psi.memorySome, &psi.memoryFull);
+    readPressureLine(ioPressureReader, &psi.ioSome, &psi.ioFull);
+    return psi;
+}
+
+void SystemInfo::recordHistory(qint64 timestampMs, double cpu, double mem)
+{
+    // Séries novas são registradas antes de montar a linha
+    while (coreSeries.size() < coreUsages.size()) {
+        coreSeries.append(history.addSeries("cpu_core", QString::number(coreSeries.size())));
+    }
+
+    const QVector<MountUsage> &mounts = filesystemStats.mounts();
+    if (fsSeriesGeneration != filesystemStats.generation()) {
+        fsSeriesGeneration = filesystemStats.generation();
+        fsSeries.clear();
+        for (const MountUsage &mount : mounts) {
+            fsSeries.append(history.addSeries("fs_used", QString::fromUtf8(mount.mountPoint), false));
+        }
+    }
+
+    // Contadores acumulados por disco; rate() nas consultas dá bytes/s
+    const QVector<DiskCounters> &disks = diskStats.disks();
+    if (diskSeriesGeneration != diskStats.generation()) {
+        diskSeriesGeneration = diskStats.generation();
+        diskReadSeries.clear();
+        diskWriteSeries.clear();
+        for (const DiskCounters &disk : disks) {
+            QString label = QString::fromLatin1(disk.name);
+            diskReadSeries.append(history.addSeries("disk_read_bytes", label, false));
+            diskWriteSeries.append(history.addSeries("disk_write_bytes", label, false));
+            logCounters[diskReadSeries.last()];
+            logCounters[diskWriteSeries.last()];
+        }
+    }
+
+    historyRow.fill(std::nan(""), history.seriesCount());
+    historyRow[cpuSeries] = cpu;
+    historyRow[memSeries] = mem;
+    if (schedStats.isAvailable()) {
+        historyRow[runqDelaySeries] = schedStats.total().waitMsPerSec;
+    }
+    for (int i = 0; i < coreUsages.size(); ++i) {
+        historyRow[coreSeries[i]] = coreUsages[i];
+    }
+    for (int i = 0; i < mounts.size(); ++i) {
+        historyRow[fsSeries[i]] = mounts[i].usedPercent();
+    }
+    for (int i = 0; i < disks.size(); ++i) {
+        historyRow[diskReadSeries[i]] = disks[i].readBytes;
+        historyRow[diskWriteSeries[i]] = disks[i].writtenBytes;
+    }
+
+    history.append(timestampMs, historyRow);
+
+    if (!historyLog.isWritable()) return;
+    while (logSeries.size() < history.seriesCount()) {
+        int id = logSeries.size();
+        QString name = history.seriesName(id);
+        if (logCounters.contains(id)) name += "_per_sec";
+        QString label = history.seriesLabel(id);
+        logSeries.append(historyLog.addSeries(label.isEmpty() ? name
+                                              : QString("%1{%2}").arg(name, label)));
+    }
+    for (int i = 0; i < historyRow.size(); ++i) {
+        double value = historyRow[i];
+        auto counter = logCounters.find(i);
+        if (counter != logCounters.end()) {
+            // Primeira leitura, contador zerado ou disco que sumiu e voltou:
+            // só guarda a referência
+            double previous = counter->last;
+            qint64 elapsedMs = timestampMs - counter->lastMs;
+            counter->last = value;
+            counter->lastMs = timestampMs;
+            if (std::isnan(previous) || std::isnan(value) || value < previous || elapsedMs <= 0) continue;
+            value = (value - previous) * 1000.0 / elapsedMs;
+        }
+        if (std::isnan(value)) continue;
+        historyLog.append(logSeries[i], timestampMs, value);
+    }
+    if (!logFlushClock.isValid() || logFlushClock.hasExpired(LogFlushIntervalMs)) {
+        logFlushClock.start();
+        historyLog.flush();
+    }
+    if (!logRetentionClock.isValid() || logRetentionClock.hasExpired(LogRetentionIntervalMs)) {
+        logRetentionClock.start();
+        historyLog.applyRetention(timestampMs);
+    }
+}
+
+void SystemInfo::checkAnomaly(const QString &metric, AnomalyDetector &detector,
+                              double value, int hourOfDay, int intervalMs)
+{
+    AnomalyDetector::Result result = detector.update(value, hourOfDay, intervalMs);
+    if (result.changed) {
+        if (result.active) {
+            qWarning() << "Anomalia em" << metric << value << "z =" << result.zScore;
+        }
+        emit anomalyChanged(metric, result.active, value, result.zScore);
+    }
+}
+
 void SystemInfo::updateStats()
 {
+    bootstrapTimer->stop();
+    if (powerCheckClock.hasExpired(PowerCheckIntervalMs)) {
+        powerCheckClock.restart();
+        bool battery = detectBatteryPower();
+        if (battery != onBattery) {
+            onBattery = battery;
+            applySamplingCadence();
+        }
+    }
+
+    // A primeira leitura de /proc/stat só serve de base para o delta
+    bool cpuPrimed = previousTotal != 0;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
     double cpu = getCpuUsage();
     double mem = getMemoryUsage();
-    emit statsUpdated(cpu, mem);
+    if (schedStats.isAvailable()) {
+        schedStats.sample();
+    }
+    if (collectorDue(PerfCollector)) {
+        perfCounters.sample();
+    }
+    bool filesystemsRefreshed = filesystemStats.sample();
+    diskStats.sample();
+
+    if (!snapshotClock.isValid() || snapshotClock.hasExpired(SnapshotIntervalMs)) {
+        snapshotClock.start();
+        snapshotProcesses.sample();
+        snapshots.append(captureSnapshot(now, snapshotProcesses, filesystemStats));
+    }
+
+    if (cpuPrimed) {
+        recordHistory(now, cpu, mem);
+
+        // Nomes fixos e hora pelo localtime_r: nada alocado por tick
+        static const QString cpuMetric("CPU");
+        static const QString memMetric("RAM");
+        time_t seconds = time_t(now / 1000);
+        tm local;
+        localtime_r(&seconds, &local);
+        // Cadência nominal, e não o tempo real: uma suspensão não deve dar
+        // horas de peso a uma única amostra
+        const int interval = timer->interval();
+        checkAnomaly(cpuMetric, cpuDetector, cpu, local.tm_hour, interval);
+        checkAnomaly(memMetric, memDetector, mem, local.tm_hour, interval);
+    }
+
+    SnapshotData *data = new SnapshotData;
+    data->version = ++snapshotVersion;
+    data->timestampMs = now;
+    data->intervalMs = timer->interval();
+    data->cpuUsage = cpu;
+    data->memUsage = mem;
+    data->coreUsages = coreUsages;
+    data->pressure = getPressure();
+    currentSnapshot = Snapshot(data);
+
+    if (publisher.isActive()) {
+        const PressureStats &psi = currentSnapshot.pressure();
+
+        SnapshotShmPayload snap = {};
+        snap.timestampMs = now;
+        snap.sampleIntervalMs = currentSnapshot.intervalMs();
+        snap.cpuUsage = cpu;
+        snap.memUsage = mem;
+        snap.psiCpuSome = psi.cpuSome;
+        snap.psiMemorySome = psi.memorySome;
+        snap.psiMemoryFull = psi.memoryFull;
+        snap.psiIoSome = psi.ioSome;
+        snap.psiIoFull = psi.ioFull;
+        publisher.publish(snap);
+    }
+
+    emit statsUpdated(currentSnapshot);
+    if (filesystemsRefreshed) {
+        emit filesystemsUpdated();
+    }
+
+    if (collectorDue(InterruptsCollector)) {
+        interruptStats.sample();
+        emit interruptsUpdated();
+    }
+
+    if (collectorDue(ProcessesCollector)) {
+        if (processEventsNotifier) drainProcessEvents();
+        processStats.sample();
+        processEvents.collect(processStats);
+        emit processesUpdated();
+    }
+
+    if (collectorDue(CgroupsCollector)) {
+        cgroupStats.sample();
+        emit cgroupsUpdated();
+    }
+
+    if (collectorDue(SocketsCollector)) {
+        socketStats.sample();
+        emit socketsUpdated();
+    }
 }
 
 #include "systeminfo.moc"
@@ -4,32 +4,207 @@
 #include <QString>
 #include <QTimer>
 #include <QObject>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QHash>
+#include <QSocketNotifier>
+#include <limits>
+#include "snapshotpublisher.h"
+#include "metrichistory.h"
+#include "anomalydetector.h"
+#include "interruptstats.h"
+#include "schedstats.h"
+#include "perfcounters.h"
+#include "cgroupstats.h"
+#include "socketstats.h"
+#include "filesystemstats.h"
+#include "processstats.h"
+#include "processevents.h"
+#include "metriclog.h"
+#include "diskstats.h"
+#include "snapshothistory.h"
+#include "snapshot.h"
+#include "procreader.h"
 
 class SystemInfo : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit SystemInfo(QObject *parent = nullptr);
+    // Coletores que só alimentam alguma view; histórico, discos e snapshots
+    // rodam sempre
+    enum Collector {
+        InterruptsCollector = 0x01,
+        ProcessesCollector = 0x02,
+        PerfCollector = 0x04,
+        CgroupsCollector = 0x08,
+        SocketsCollector = 0x10
+    };
+
+    // Serviço único do processo: janelas e frontends compartilham as mesmas
+    // leituras do /proc em vez de cada um ter o seu SystemInfo
+    static SystemInfo *instance();
 
     QString getCpuModel();
     QString getRamInfo();
     double getCpuUsage();
     double getMemoryUsage();
+    PressureStats getPressure();
+    // Último snapshot emitido por statsUpdated(); inválido antes do primeiro tick
+    Snapshot getSnapshot() const { return currentSnapshot; }
+    const MetricHistory &getHistory() const { return history; }
+    // Tempo coberto pelo anel do histórico no ritmo visível
+    qint64 getHistorySpanMs() const { return qint64(history.capacity()) * VisibleIntervalMs; }
+
+    // Cada view assina os coletores (máscara de Collector) e o intervalo de
+    // que precisa; chamar de novo substitui a assinatura anterior. O tick
+    // segue o menor intervalo entre os assinantes visíveis e cada coletor
+    // roda no ritmo de quem o pediu; sem assinante visível sobra só o
+    // histórico, em ritmo reduzido. Assinantes destruídos saem sozinhos.
+    void subscribe(QObject *subscriber, int collectors, int intervalMs = VisibleIntervalMs);
+    void setSubscriberVisible(QObject *subscriber, bool visible);
+    void unsubscribe(QObject *subscriber);
+    bool isOnBattery() const { return onBattery; }
+
+    const InterruptStats &getInterruptStats() const { return interruptStats; }
+    const SchedStats &getSchedStats() const { return schedStats; }
+    const PerfCounters &getPerfCounters() const { return perfCounters; }
+    const CgroupStats &getCgroupStats() const { return cgroupStats; }
+    const SocketStats &getSocketStats() const { return socketStats; }
+    const FilesystemStats &getFilesystemStats() const { return filesystemStats; }
+    const ProcessStats &getProcessStats() const { return processStats; }
+    const ProcessEvents &getProcessEvents() const { return processEvents; }
+    const SnapshotHistory &getSnapshotHistory() const { return snapshots; }
 
 private slots:
     void updateStats();
 
 signals:
-    void statsUpdated(double cpuUsage, double memUsage);
+    // Um snapshot por tick, compartilhado entre todos os receptores
+    void statsUpdated(const Snapshot &snapshot);
+    // Canal de alertas: emitido só quando a métrica entra ou sai de anomalia
+    void anomalyChanged(const QString &metric, bool active, double value, double zScore);
+    void interruptsUpdated();
+    void filesystemsUpdated();
+    void processesUpdated();
+    void cgroupsUpdated();
+    void socketsUpdated();
 
 private:
+    explicit SystemInfo(QObject *parent = nullptr);
+
+    struct Subscription
+    {
+        int collectors = 0;
+        int intervalMs = VisibleIntervalMs;
+        bool visible = true;
+    };
+
+    void updateSubscriptions();
+    void drainProcessEvents();
+    bool collectorDue(Collector collector);
+
     QTimer *timer;
+    // Amostra avulsa ao aparecer, agendada para que o delta de CPU cubra
+    // pelo menos BootstrapDelayMs
+    QTimer *bootstrapTimer;
+    QElapsedTimer cpuReadClock;
     QString readFile(const QString &path);
     double calculateCpuUsage();
+    void recordHistory(qint64 timestampMs, double cpu, double mem);
+    void checkAnomaly(const QString &metric, AnomalyDetector &detector,
+                      double value, int hourOfDay, int intervalMs);
+    void readPressureLine(ProcReader &reader, double *some, double *full);
+    bool detectBatteryPower();
+    void applySamplingCadence();
+
+    static constexpr int VisibleIntervalMs = 1000;
+    static constexpr int BootstrapDelayMs = 100;
+    static constexpr int CollectorCount = 5;
+    static constexpr int HiddenIntervalMs = 5000;
+    static constexpr int BatteryHiddenIntervalMs = 15000;
+    static constexpr int PowerCheckIntervalMs = 30000;
+
+    // Arquivos lidos a cada tick: descritor e buffer reaproveitados, e a
+    // varredura trabalha direto sobre os bytes, sem QString intermediária
+    ProcReader statReader;
+    ProcReader meminfoReader;
+    ProcReader cpuPressureReader;
+    ProcReader memoryPressureReader;
+    ProcReader ioPressureReader;
 
     long long previousIdle;
     long long previousTotal;
+    QVector<long long> previousCoreIdle;
+    QVector<long long> previousCoreTotal;
+    QVector<double> coreUsages;
+    Snapshot currentSnapshot;
+    quint64 snapshotVersion;
+
+    MetricHistory history;
+    int cpuSeries;
+    int memSeries;
+    int runqDelaySeries;
+    QVector<int> coreSeries;
+    QVector<int> fsSeries;
+    quint32 fsSeriesGeneration;
+    QVector<int> diskReadSeries;
+    QVector<int> diskWriteSeries;
+    quint32 diskSeriesGeneration;
+    QVector<double> historyRow;
+
+    AnomalyDetector cpuDetector;
+    AnomalyDetector memDetector;
+
+    bool windowVisible;         // algum assinante visível
+    bool onBattery;
+    QElapsedTimer powerCheckClock;
+
+    QHash<QObject *, Subscription> subscriptions;
+    int activeCollectors;       // união das assinaturas visíveis
+    int visibleIntervalMs;
+    int collectorIntervals[CollectorCount];
+    QElapsedTimer collectorClocks[CollectorCount];
+
+    SnapshotPublisher publisher;
+
+    InterruptStats interruptStats;
+    SchedStats schedStats;
+    PerfCounters perfCounters;
+    FilesystemStats filesystemStats;
+    DiskStats diskStats;
+
+    ProcessStats processStats;
+    // Aberto junto com a aba Processos; o notifier só existe com o proc connector
+    ProcessEvents processEvents;
+    QSocketNotifier *processEventsNotifier;
+    CgroupStats cgroupStats;
+    SocketStats socketStats;
+
+    // Gravação em disco do histórico; só a instância que publica o snapshot
+    // grava, para não haver dois escritores no mesmo diretório
+    static constexpr int LogFlushIntervalMs = 10000;
+    MetricLog historyLog;
+    QVector<int> logSeries;      // id no MetricHistory -> série no log
+    // Contadores acumulados (bytes de disco) vão para o log já como bytes/s:
+    // um acumulado de 1e12 não cabe num float e a pirâmide min/máx/média de
+    // um contador não diz nada
+    struct LogCounter
+    {
+        double last = std::numeric_limits<double>::quiet_NaN();
+        qint64 lastMs = 0;
+    };
+    QHash<int, LogCounter> logCounters;  // id no MetricHistory -> última leitura
+    QElapsedTimer logFlushClock;
+    static constexpr int LogRetentionIntervalMs = 3600000;
+    QElapsedTimer logRetentionClock;
+
+    // Snapshot completo a cada minuto para a aba de diferenças; varredura
+    // de processos própria, independente da aba Processos
+    static constexpr int SnapshotIntervalMs = 60000;
+    ProcessStats snapshotProcesses;
+    SnapshotHistory snapshots;
+    QElapsedTimer snapshotClock;
 };
 
 #endif
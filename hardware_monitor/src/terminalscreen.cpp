@@ -0,0 +1,266 @@
+#include "terminalscreen.h"
+#include <cerrno>
+#include <cmath>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+void appendNumber(QByteArray &out, int n)
+{
+    char digits[12];
+    int len = 0;
+    do {
+        digits[len++] = char('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+    while (len > 0) out.append(digits[--len]);
+}
+
+void appendUtf8(QByteArray &out, uint ch)
+{
+    if (ch < 0x80) {
+        out.append(char(ch));
+    } else if (ch < 0x800) {
+        out.append(char(0xc0 | (ch >> 6)));
+        out.append(char(0x80 | (ch & 0x3f)));
+    } else if (ch < 0x10000) {
+        out.append(char(0xe0 | (ch >> 12)));
+        out.append(char(0x80 | ((ch >> 6) & 0x3f)));
+        out.append(char(0x80 | (ch & 0x3f)));
+    } else {
+        out.append(char(0xf0 | (ch >> 18)));
+        out.append(char(0x80 | ((ch >> 12) & 0x3f)));
+        out.append(char(0x80 | ((ch >> 6) & 0x3f)));
+        out.append(char(0x80 | (ch & 0x3f)));
+    }
+}
+
+}
+
+TerminalScreen::TerminalScreen(int fd)
+    : fd(fd), cols(0), lines(0), cursorX(-1), cursorY(-1),
+      currentStyle(-1), fullRedraw(true), active(false)
+{
+}
+
+TerminalScreen::~TerminalScreen()
+{
+    close();
+}
+
+bool TerminalScreen::open()
+{
+    if (!isatty(fd) || tcgetattr(STDIN_FILENO, &savedTermios) != 0) {
+        return false;
+    }
+
+    // Sem eco nem buffer de linha; ISIG fica para Ctrl+C chegar como sinal
+    struct termios raw = savedTermios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+
+    writeAll("\x1b[?1049h\x1b[?25l");
+    active = true;
+    updateSize();
+    invalidate();
+    return true;
+}
+
+void TerminalScreen::close()
+{
+    if (!active) return;
+    writeAll("\x1b[0m\x1b[?25h\x1b[?1049l");
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios);
+    active = false;
+}
+
+bool TerminalScreen::updateSize()
+{
+    struct winsize ws = {};
+    int newCols = 80;
+    int newLines = 24;
+    if (ioctl(fd, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+        newCols = ws.ws_col;
+        newLines = ws.ws_row;
+    }
+    if (newCols == cols && newLines == lines) return false;
+
+    cols = newCols;
+    lines = newLines;
+    front.resize(cols * lines);
+    back.resize(cols * lines);
+    invalidate();
+    return true;
+}
+
+void TerminalScreen::invalidate()
+{
+    fullRedraw = true;
+}
+
+void TerminalScreen::clear()
+{
+    back.fill(Cell());
+}
+
+void TerminalScreen::put(int x, int y, uint ch, quint8 style)
+{
+    if (x < 0 || y < 0 || x >= cols || y >= lines) return;
+    // Controles no meio do texto (nomes de processo) bagunçariam a tela
+    if (ch < 0x20 || ch == 0x7f) ch = '?';
+    Cell &cell = back[y * cols + x];
+    cell.ch = ch;
+    cell.style = style;
+}
+
+int TerminalScreen::text(int x, int y, const QString &s, quint8 style, int maxWidth)
+{
+    int end = maxWidth < 0 ? cols : qMin(cols, x + maxWidth);
+    const QVector<uint> codepoints = s.toUcs4();
+    for (uint ch : codepoints) {
+        if (x >= end) break;
+        put(x++, y, ch, style);
+    }
+    return x;
+}
+
+int TerminalScreen::text(int x, int y, const char *s, quint8 style, int maxWidth)
+{
+    // ASCII direto; o resto passa pela decodificação UTF-8 do QString
+    const char *p = s;
+    while (*p && !(*p & 0x80)) ++p;
+    if (*p) return text(x, y, QString::fromUtf8(s), style, maxWidth);
+
+    int end = maxWidth < 0 ? cols : qMin(cols, x + maxWidth);
+    for (p = s; *p && x < end; ++p) {
+        put(x++, y, uchar(*p), style);
+    }
+    return x;
+}
+
+void TerminalScreen::bar(int x, int y, int width, double fraction, quint8 style)
+{
+    if (width < 3) return;
+    int inner = width - 2;
+    int filled = int(std::lround(qBound(0.0, fraction, 1.0) * inner));
+    put(x, y, '[', Default);
+    for (int i = 0; i < inner; ++i) {
+        put(x + 1 + i, y, i < filled ? '|' : ' ', i < filled ? style : quint8(Default));
+    }
+    put(x + width - 1, y, ']', Default);
+}
+
+void TerminalScreen::moveTo(int x, int y)
+{
+    if (cursorY == y && cursorX == x) return;
+
+    if (cursorY == y && cursorX >= 0 && x > cursorX) {
+        out.append("\x1b[");
+        appendNumber(out, x - cursorX);
+        out.append('C');
+    } else if (x == 0 && cursorY >= 0 && y == cursorY + 1) {
+        out.append("\r\n");
+    } else {
+        out.append("\x1b[");
+        appendNumber(out, y + 1);
+        if (x > 0) {
+            out.append(';');
+            appendNumber(out, x + 1);
+        }
+        out.append('H');
+    }
+    cursorX = x;
+    cursorY = y;
+}
+
+void TerminalScreen::setStyle(quint8 style)
+{
+    if (style == currentStyle) return;
+
+    out.append("\x1b[0");
+    if (style & Bold) out.append(";1");
+    if (style & Reverse) out.append(";7");
+    if (style & 0x0f) {
+        out.append(";3");
+        out.append(char('0' + (style & 0x0f)));
+    }
+    out.append('m');
+    currentStyle = style;
+}
+
+void TerminalScreen::emitCell(const Cell &cell)
+{
+    setStyle(cell.style);
+    appendUtf8(out, cell.ch);
+    // Na última coluna o cursor fica em "wrap pendente": posição incerta
+    cursorX = cursorX + 1 < cols ? cursorX + 1 : -1;
+}
+
+int TerminalScreen::flush()
+{
+    if (!active) return 0;
+
+    out.clear();
+    if (fullRedraw) {
+        // Depois de limpar, o terminal está todo em branco: só o conteúdo sai
+        out.append("\x1b[0m\x1b[2J");
+        currentStyle = Default;
+        cursorX = cursorY = -1;
+        front.fill(Cell());
+        fullRedraw = false;
+    }
+
+    const Cell blank;
+    for (int y = 0; y < lines; ++y) {
+        Cell *f = front.data() + y * cols;
+        const Cell *b = back.constData() + y * cols;
+
+        int lastContent = cols - 1;
+        while (lastContent >= 0 && b[lastContent] == blank) --lastContent;
+
+        for (int x = 0; x <= lastContent; ++x) {
+            if (b[x] == f[x]) continue;
+
+            // Intervalo curto de células iguais: reescrever sai mais barato
+            // que uma sequência de movimento
+            if (cursorY == y && cursorX >= 0 && cursorX < x && x - cursorX <= 3) {
+                while (cursorX >= 0 && cursorX < x) emitCell(b[cursorX]);
+            } else {
+                moveTo(x, y);
+            }
+            emitCell(b[x]);
+            f[x] = b[x];
+        }
+
+        // Resto da linha em branco: um único "apagar até o fim"
+        for (int x = lastContent + 1; x < cols; ++x) {
+            if (f[x] == blank) continue;
+            moveTo(lastContent + 1, y);
+            setStyle(Default);
+            out.append("\x1b[K");
+            for (int i = lastContent + 1; i < cols; ++i) f[i] = blank;
+            break;
+        }
+    }
+
+    writeAll(out);
+    return out.size();
+}
+
+void TerminalScreen::writeAll(const QByteArray &data)
+{
+    const char *p = data.constData();
+    qint64 left = data.size();
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, size_t(left));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += n;
+        left -= n;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef TERMINALSCREEN_H
+#define TERMINALSCREEN_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <termios.h>
+
+// Tela de terminal com dois buffers de células: o quadro é desenhado
+// inteiro em "back" e flush() envia só as células que diferem de "front"
+// (o que o terminal já mostra), com o menor movimento de cursor possível e
+// SGR apenas quando o estilo muda. Tudo sai num único write().
+class TerminalScreen
+{
+public:
+    enum Color : quint8 {
+        Default = 0, Red = 1, Green = 2, Yellow = 3, Blue = 4, Magenta = 5, Cyan = 6, White = 7
+    };
+    enum Attribute : quint8 { Bold = 0x10, Reverse = 0x20 };
+
+    explicit TerminalScreen(int fd = 1);
+    ~TerminalScreen();
+
+    // Modo raw, tela alternativa e cursor oculto; close() desfaz tudo
+    bool open();
+    void close();
+
+    // Relê o tamanho do terminal; true se mudou (próximo flush redesenha tudo)
+    bool updateSize();
+    int columns() const { return cols; }
+    int rows() const { return lines; }
+
+    void clear();
+    // Escreve a partir de (x, y) cortando em maxWidth colunas (-1 = até a
+    // borda); devolve a coluna seguinte ao texto
+    int text(int x, int y, const QString &s, quint8 style = Default, int maxWidth = -1);
+    int text(int x, int y, const char *s, quint8 style = Default, int maxWidth = -1);
+    // Barra horizontal de width colunas preenchida em fraction (0..1)
+    void bar(int x, int y, int width, double fraction, quint8 style);
+
+    // Envia a diferença para o terminal; devolve os bytes escritos
+    int flush();
+    // Força redesenho completo no próximo flush (ex.: Ctrl+L)
+    void invalidate();
+
+private:
+    struct Cell
+    {
+        uint ch = ' ';
+        quint8 style = Default;
+
+        bool operator==(const Cell &o) const { return ch == o.ch && style == o.style; }
+        bool operator!=(const Cell &o) const { return !(*this == o); }
+    };
+
+    void put(int x, int y, uint ch, quint8 style);
+    void moveTo(int x, int y);
+    void setStyle(quint8 style);
+    void emitCell(const Cell &cell);
+    void writeAll(const QByteArray &data);
+
+    int fd;
+    int cols;
+    int lines;
+    QVector<Cell> front;
+    QVector<Cell> back;
+    QByteArray out;          // reaproveitado entre quadros
+    int cursorX;             // -1 = posição desconhecida
+    int cursorY;
+    int currentStyle;        // -1 = desconhecido
+    bool fullRedraw;
+    bool active;
+    struct termios savedTermios;
+};
+
+#endif
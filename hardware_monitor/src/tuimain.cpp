@@ -0,0 +1,25 @@
+#include <QCoreApplication>
+#include <cstdio>
+#include "systeminfo.h"
+#include "terminalscreen.h"
+#include "tuiview.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Mesmo nome da interface gráfica: histórico gravado no mesmo diretório
+    QCoreApplication::setApplicationName("HardwareMonitor");
+
+    TerminalScreen screen;
+    if (!screen.open()) {
+        std::fprintf(stderr, "hwmon-tui: a saída precisa ser um terminal\n");
+        return 1;
+    }
+    TuiView::installSignalHandlers();
+
+    TuiView view(SystemInfo::instance(), &screen);
+    int rc = app.exec();
+
+    screen.close();
+    return rc;
+}
@@ -0,0 +1,236 @@
+#include "tuiview.h"
+#include <QCoreApplication>
+#include <QTime>
+#include <algorithm>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+int signalPipe[2] = { -1, -1 };
+
+void onUnixSignal(int signo)
+{
+    char byte = char(signo);
+    ssize_t ignored = ::write(signalPipe[1], &byte, 1);
+    (void)ignored;
+}
+
+quint8 usageStyle(double percent)
+{
+    if (percent >= 85.0) return TerminalScreen::Red | TerminalScreen::Bold;
+    if (percent >= 60.0) return TerminalScreen::Yellow;
+    return TerminalScreen::Green;
+}
+
+}
+
+TuiView::TuiView(SystemInfo *info, TerminalScreen *screen, QObject *parent)
+    : QObject(parent), info(info), screen(screen), signalNotifier(nullptr),
+      sortKey(SortCpu), lastFrameBytes(0)
+{
+    cpuModel = info->getCpuModel();
+    ramInfo = info->getRamInfo();
+    // O quadro sai depois da varredura de processos, que fecha cada amostra
+    connect(info, &SystemInfo::statsUpdated, this, &TuiView::updateStats);
+    connect(info, &SystemInfo::processesUpdated, this, &TuiView::render);
+    info->subscribe(this, SystemInfo::ProcessesCollector);
+
+    inputNotifier = new QSocketNotifier(STDIN_FILENO, QSocketNotifier::Read, this);
+    connect(inputNotifier, &QSocketNotifier::activated, this, &TuiView::readInput);
+
+    if (signalPipe[0] >= 0) {
+        signalNotifier = new QSocketNotifier(signalPipe[0], QSocketNotifier::Read, this);
+        connect(signalNotifier, &QSocketNotifier::activated, this, &TuiView::readSignal);
+    }
+
+    render();
+}
+
+bool TuiView::installSignalHandlers()
+{
+    if (pipe2(signalPipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+        return false;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = onUnixSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGWINCH, &action, nullptr);
+    return true;
+}
+
+void TuiView::updateStats(const Snapshot &latest)
+{
+    snapshot = latest;
+}
+
+void TuiView::readInput()
+{
+    char keys[32];
+    ssize_t n = ::read(STDIN_FILENO, keys, sizeof(keys));
+    if (n <= 0) return;
+
+    bool redraw = false;
+    for (ssize_t i = 0; i < n; ++i) {
+        switch (keys[i]) {
+        case 'q':
+            QCoreApplication::quit();
+            return;
+        case 'c': sortKey = SortCpu; redraw = true; break;
+        case 'm': sortKey = SortMemory; redraw = true; break;
+        case 'p': sortKey = SortPid; redraw = true; break;
+        case 0x0c:   // Ctrl+L
+            screen->invalidate();
+            redraw = true;
+            break;
+        default:
+            break;
+        }
+    }
+    if (redraw) render();
+}
+
+void TuiView::readSignal()
+{
+    char received[16];
+    ssize_t n = ::read(signalPipe[0], received, sizeof(received));
+    for (ssize_t i = 0; i < n; ++i) {
+        if (received[i] == SIGWINCH) {
+            if (screen->updateSize()) render();
+        } else {
+            QCoreApplication::quit();
+        }
+    }
+}
+
+void TuiView::render()
+{
+    screen->clear();
+    int y = drawHeader();
+    y = drawCores(y);
+    y = drawFilesystems(y);
+    drawProcesses(y + 1, screen->rows() - 2);
+    drawFooter();
+    lastFrameBytes = screen->flush();
+}
+
+int TuiView::drawHeader()
+{
+    int cols = screen->columns();
+    int x = screen->text(0, 0, "Monitor de Hardware", TerminalScreen::Bold);
+    screen->text(x, 0, QString(" - %1 - %2").arg(cpuModel, ramInfo), TerminalScreen::Default,
+                 cols - x - 10);
+    screen->text(cols - 8, 0, QTime::currentTime().toString("HH:mm:ss"));
+
+    double cpu = snapshot.cpuUsage();
+    double mem = snapshot.memUsage();
+    int half = cols / 2;
+    int barWidth = qMax(3, half - 14);
+    screen->text(0, 1, "CPU", TerminalScreen::Bold);
+    screen->bar(4, 1, barWidth, cpu / 100.0, usageStyle(cpu));
+    screen->text(5 + barWidth, 1, QString("%1%").arg(cpu, 5, 'f', 1));
+    screen->text(half, 1, "RAM", TerminalScreen::Bold);
+    screen->bar(half + 4, 1, barWidth, mem / 100.0, usageStyle(mem));
+    screen->text(half + 5 + barWidth, 1, QString("%1%").arg(mem, 5, 'f', 1));
+
+    const PressureStats &psi = snapshot.pressure();
+    screen->text(0, 2, QString("PSI  cpu %1   mem %2/%3   io %4/%5")
+                       .arg(psi.cpuSome, 0, 'f', 2)
+                       .arg(psi.memorySome, 0, 'f', 2).arg(psi.memoryFull, 0, 'f', 2)
+                       .arg(psi.ioSome, 0, 'f', 2).arg(psi.ioFull, 0, 'f', 2));
+    return 3;
+}
+
+int TuiView::drawCores(int y)
+{
+    // Núcleos em colunas de 20 caracteres: "12 [||||    ]  45%"
+    static constexpr int CellWidth = 20;
+    const QVector<double> &cores = snapshot.coreUsages();
+    int perRow = qMax(1, screen->columns() / CellWidth);
+    for (int i = 0; i < cores.size(); ++i) {
+        int x = (i % perRow) * CellWidth;
+        int row = y + i / perRow;
+        screen->text(x, row, QString("%1").arg(i, 2));
+        screen->bar(x + 3, row, CellWidth - 9, cores[i] / 100.0, usageStyle(cores[i]));
+        screen->text(x + CellWidth - 5, row, QString("%1%").arg(cores[i], 3, 'f', 0));
+    }
+    return y + (cores.size() + perRow - 1) / perRow;
+}
+
+int TuiView::drawFilesystems(int y)
+{
+    static constexpr int MaxMounts = 4;
+    const QVector<MountUsage> &mounts = info->getFilesystemStats().mounts();
+    int cols = screen->columns();
+    int barWidth = qMax(3, cols - 46);
+    for (int i = 0; i < mounts.size() && i < MaxMounts; ++i) {
+        const MountUsage &mount = mounts[i];
+        double used = mount.usedPercent();
+        screen->text(0, y, QString::fromUtf8(mount.mountPoint), TerminalScreen::Default, 15);
+        screen->bar(16, y, barWidth, used / 100.0, usageStyle(used));
+        screen->text(17 + barWidth, y, QString("%1%  %2/%3 GB")
+                                           .arg(used, 3, 'f', 0)
+                                           .arg(mount.usedBytes / 1e9, 0, 'f', 1)
+                                           .arg(mount.totalBytes / 1e9, 0, 'f', 1));
+        ++y;
+    }
+    return y;
+}
+
+void TuiView::drawProcesses(int y, int lastRow)
+{
+    const ProcessStats &stats = info->getProcessStats();
+    const QVector<ProcessInfo> &processes = stats.processes();
+    const StringPool &strings = stats.strings();
+    int cols = screen->columns();
+
+    QString header = QString("%1 %2 %3 %4 S  COMANDO")
+                         .arg("PID", 7).arg("USUÁRIO", -10).arg("CPU%", 6).arg("RSS MB", 8);
+    screen->text(0, y, header.leftJustified(cols, ' '), TerminalScreen::Reverse);
+    ++y;
+
+    int visible = qMax(0, qMin(processes.size(), lastRow - y + 1));
+    order.resize(processes.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+
+    // Só as linhas que cabem na tela precisam estar ordenadas
+    auto compare = [&](int a, int b) {
+        const ProcessInfo &pa = processes[a];
+        const ProcessInfo &pb = processes[b];
+        switch (sortKey) {
+        case SortMemory: return pa.rssKb > pb.rssKb;
+        case SortPid: return pa.pid < pb.pid;
+        default: return pa.cpuPercent > pb.cpuPercent;
+        }
+    };
+    if (sortKey != SortPid) {
+        std::partial_sort(order.begin(), order.begin() + visible, order.end(), compare);
+    }
+
+    for (int i = 0; i < visible; ++i, ++y) {
+        const ProcessInfo &p = processes[order[i]];
+        int x = screen->text(0, y, QString("%1 %2 %3 %4 %5  ")
+                                       .arg(p.pid, 7)
+                                       .arg(strings.string(p.user).left(10), -10)
+                                       .arg(p.cpuPercent, 6, 'f', 1)
+                                       .arg(p.rssKb / 1024.0, 8, 'f', 1)
+                                       .arg(QChar(p.state)));
+        screen->text(x, y, strings.string(p.name), TerminalScreen::Bold);
+    }
+}
+
+void TuiView::drawFooter()
+{
+    static const char *const sortNames[] = { "CPU", "memória", "pid" };
+    int y = screen->rows() - 1;
+    QString footer = QString(" q sair  c/m/p ordenar (%1)  Ctrl+L redesenhar  último quadro: %2 bytes")
+                         .arg(sortNames[sortKey]).arg(lastFrameBytes);
+    screen->text(0, y, footer.leftJustified(screen->columns(), ' '), TerminalScreen::Reverse);
+}
+
+#include "tuiview.moc"
@@ -0,0 +1,50 @@
+#ifndef TUIVIEW_H
+#define TUIVIEW_H
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QVector>
+#include "systeminfo.h"
+#include "terminalscreen.h"
+
+// Frontend de terminal no estilo do top sobre os mesmos coletores da
+// interface gráfica. Um quadro por amostra: CPU/RAM, núcleos, PSI,
+// sistemas de arquivos e a tabela de processos ordenável.
+class TuiView : public QObject
+{
+    Q_OBJECT
+
+public:
+    TuiView(SystemInfo *info, TerminalScreen *screen, QObject *parent = nullptr);
+
+    // SIGINT/SIGTERM/SIGWINCH viram bytes num pipe lido pelo laço de eventos
+    static bool installSignalHandlers();
+
+private slots:
+    void updateStats(const Snapshot &latest);
+    void render();
+    void readInput();
+    void readSignal();
+
+private:
+    enum SortKey { SortCpu, SortMemory, SortPid };
+
+    int drawHeader();
+    int drawCores(int y);
+    int drawFilesystems(int y);
+    void drawProcesses(int y, int lastRow);
+    void drawFooter();
+
+    SystemInfo *info;
+    TerminalScreen *screen;
+    QSocketNotifier *inputNotifier;
+    QSocketNotifier *signalNotifier;
+    QString cpuModel;
+    QString ramInfo;
+    Snapshot snapshot;
+    SortKey sortKey;
+    QVector<int> order;      // índices em processes(), reaproveitado
+    int lastFrameBytes;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// Inteiros em base 128 (7 bits por byte, bit alto = continua) e zigzag para
+// que diferenças pequenas, positivas ou negativas, ocupem um byte
+
+inline void putVarint(QByteArray &out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char(value | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+// Avança p; num número truncado para em end com o que já foi lido
+inline quint64 getVarint(const char *&p, const char *end)
+{
+    quint64 value = 0;
+    int shift = 0;
+    while (p < end && shift < 64) {
+        quint8 byte = quint8(*p++);
+        value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    return value;
+}
+
+inline quint64 zigzag(qint64 value)
+{
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+inline qint64 unzigzag(quint64 value)
+{
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+#endif